@@ -0,0 +1,74 @@
+#include "accumulator.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace {
+// A position can absorb this many digits below 2^32 without overflowing.
+const uint64_t kMaxPendingTerms = 0xFFFFFFFFULL;
+
+// Pushes carries up so that every position is below 2^32.
+void propagate_carries(std::vector<uint64_t>* sums) {
+  uint64_t carry = 0;
+  for (uint64_t& sum : *sums) {
+    sum += carry;
+    carry = sum >> 32;
+    sum &= 0xFFFFFFFFULL;
+  }
+  while (carry != 0) {
+    sums->push_back(carry & 0xFFFFFFFFULL);
+    carry >>= 32;
+  }
+}
+
+Int to_int(std::vector<uint64_t> sums) {
+  propagate_carries(&sums);
+  return Int(std::vector<uint32_t>(sums.begin(), sums.end()));
+}
+}  // namespace
+
+IntAccumulator::IntAccumulator() : IntAccumulator(kMaxPendingTerms) {}
+
+IntAccumulator::IntAccumulator(uint64_t max_pending_terms)
+    : pending_terms(0), max_pending_terms(max_pending_terms) {
+  assert(max_pending_terms >= 2 && max_pending_terms <= kMaxPendingTerms);
+}
+
+IntAccumulator& IntAccumulator::operator+=(const Int& rhs) {
+  add_magnitude(rhs, false);
+  return *this;
+}
+
+IntAccumulator& IntAccumulator::operator-=(const Int& rhs) {
+  add_magnitude(rhs, true);
+  return *this;
+}
+
+Int IntAccumulator::value() const {
+  return to_int(positive) - to_int(negative);
+}
+
+void IntAccumulator::clear() {
+  positive.clear();
+  negative.clear();
+  pending_terms = 0;
+}
+
+void IntAccumulator::add_magnitude(const Int& a, bool negate) {
+  if (pending_terms == max_pending_terms) {
+    // Afterwards every position holds less than one more digit.
+    propagate_carries(&positive);
+    propagate_carries(&negative);
+    pending_terms = 1;
+  }
+  ++pending_terms;
+  std::vector<uint64_t>& sums = (a.sign() < 0) != negate ? negative : positive;
+  const std::vector<uint32_t>& digits = a.get_digits();
+  if (sums.size() < digits.size()) {
+    sums.resize(digits.size(), 0);
+  }
+  for (size_t i = 0; i < digits.size(); ++i) {
+    sums[i] += digits[i];
+  }
+}
@@ -0,0 +1,41 @@
+#ifndef NUMBER_SRC_ACCUMULATOR_H
+#define NUMBER_SRC_ACCUMULATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "integer.h"
+
+// Sums a long stream of Ints without propagating carries on each addition.
+// Every position holds a 64 bit sum of base 2^32 digits, so about 2^32 terms
+// can be absorbed before carries have to be pushed up, and positive and
+// negative terms are summed separately so that no magnitudes are compared.
+// Each addition costs O(size of the operand).
+class IntAccumulator {
+ public:
+  IntAccumulator();
+  // Propagates carries after at most max_pending_terms additions instead of
+  // the default of 2^32 - 1, which is also the largest allowed value. A small
+  // cap lets tests reach the propagation. Requires max_pending_terms >= 2.
+  explicit IntAccumulator(uint64_t max_pending_terms);
+  IntAccumulator& operator+=(const Int& rhs);
+  IntAccumulator& operator-=(const Int& rhs);
+  // Returns the sum of everything added so far.
+  Int value() const;
+  void clear();
+
+ private:
+  // positive[i] and negative[i] are the sums of the i-th digits of the
+  // positive and negative terms respectively.
+  std::vector<uint64_t> positive;
+  std::vector<uint64_t> negative;
+
+  // Upper bound on the number of digits summed into any position since
+  // carries were last propagated.
+  uint64_t pending_terms;
+  uint64_t max_pending_terms;
+
+  void add_magnitude(const Int& a, bool negate);
+};
+
+#endif  // NUMBER_SRC_ACCUMULATOR_H
@@ -0,0 +1,75 @@
+#include "accumulator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "integer.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "gtest/gtest.h"
+#pragma clang diagnostic pop
+
+TEST(AccumulatorTest, Empty) {
+  IntAccumulator acc;
+  EXPECT_EQ(acc.value(), 0);
+  acc += 0;
+  acc -= 0;
+  EXPECT_EQ(acc.value(), 0);
+}
+
+TEST(AccumulatorTest, MixedSigns) {
+  IntAccumulator acc;
+  acc += 5;
+  acc += -7;
+  EXPECT_EQ(acc.value(), -2);
+  acc -= -10;
+  EXPECT_EQ(acc.value(), 8);
+  acc -= 8;
+  EXPECT_EQ(acc.value(), 0);
+  EXPECT_EQ(acc.value().sign(), 1);
+  acc.clear();
+  EXPECT_EQ(acc.value(), 0);
+}
+
+TEST(AccumulatorTest, ManyTerms) {
+  const Int big{
+      "26959946667150639794667015087019630673637144422540572481103610249215"};
+  const Int max_digit{"4294967295"};
+  IntAccumulator acc;
+  Int expected{0};
+  for (int32_t i = 0; i < 5000; ++i) {
+    const Int term = (i % 3 == 0 ? big : max_digit) * (i % 7 == 0 ? -i : i);
+    acc += term;
+    expected += term;
+  }
+  EXPECT_EQ(acc.value(), expected);
+  for (int32_t i = 0; i < 100; ++i) {
+    acc -= big;
+    expected -= big;
+  }
+  EXPECT_EQ(acc.value(), expected);
+}
+
+TEST(AccumulatorTest, CarryPropagation) {
+  // With a small cap carries are propagated every few terms, and all ones
+  // digits carry out of every position, including the top one.
+  const std::vector<uint32_t> ones(5, 0xFFFFFFFFU);
+  for (const uint64_t cap : {2, 3, 7}) {
+    IntAccumulator acc(cap);
+    Int expected{0};
+    for (size_t i = 0; i < 200; ++i) {
+      const Int term(
+          std::vector<uint32_t>(ones.begin(), ones.begin() + 1 + i % 5),
+          i % 4 == 3);
+      acc += term;
+      expected += term;
+      if (i % 50 == 49) {
+        EXPECT_EQ(acc.value(), expected) << cap;
+      }
+    }
+    EXPECT_EQ(acc.value(), expected) << cap;
+    acc.clear();
+    EXPECT_EQ(acc.value(), 0);
+  }
+}
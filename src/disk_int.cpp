@@ -0,0 +1,786 @@
+#include "disk_int.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mpn.h"
+
+namespace {
+// The transforms work modulo this prime. Its multiplicative group has order
+// divisible by 2^32, so it has roots of unity of every power of two length up
+// to 2^32.
+const uint64_t kPrime = 0xFFFFFFFF00000001ULL;
+// 2^64 mod kPrime.
+const uint64_t kEpsilon = 0xFFFFFFFFULL;
+// Generates the multiplicative group modulo kPrime.
+const uint64_t kGenerator = 7;
+
+// Digits are split into 16 bit coefficients. A product of two coefficients is
+// below 2^32 and a convolution of length at most 2^32 adds at most 2^31 such
+// products, so the exact coefficients of the product are below kPrime.
+const size_t kMaxTotalDigits = size_t{1} << 31;
+
+// Decimal output is produced nine digits at a time. Values below
+// 10^(9 * kDecimalLeafChunks) are converted by repeated division by 10^9, and
+// larger ones are split at the powers 10^(9 * kDecimalLeafChunks * 2^k).
+const uint32_t kDecimalChunk = 1000000000;
+const int kDecimalChunkDigits = 9;
+const size_t kDecimalLeafChunks = 32;
+
+// From this many digits in the shorter operand, intermediate products use
+// the transform even when Karatsuba's scratch would fit in the budget. The
+// decimal conversion is within 10% of its best time from 4096 to 16384.
+const size_t kTransformMultiplyThreshold = 16384;
+
+std::runtime_error system_error(const std::string& what) {
+  return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+uint64_t add_mod(uint64_t a, uint64_t b) {
+  const uint64_t sum = a + b;
+  if (sum < a) {
+    return sum + kEpsilon;
+  }
+  return sum >= kPrime ? sum - kPrime : sum;
+}
+
+uint64_t subtract_mod(uint64_t a, uint64_t b) {
+  return a >= b ? a - b : a + (kPrime - b);
+}
+
+uint64_t multiply_mod(uint64_t a, uint64_t b) {
+  const unsigned __int128 x = static_cast<unsigned __int128>(a) * b;
+  const uint64_t lo = static_cast<uint64_t>(x);
+  const uint64_t hi = static_cast<uint64_t>(x >> 64);
+  const uint64_t hi_hi = hi >> 32;
+  const uint64_t hi_lo = hi & kEpsilon;
+  // x = lo + hi_lo * 2^64 + hi_hi * 2^96, where 2^64 = 2^32 - 1 and
+  // 2^96 = -1 modulo kPrime.
+  uint64_t t0 = lo - hi_hi;
+  if (lo < hi_hi) {
+    t0 -= kEpsilon;
+  }
+  const uint64_t t1 = hi_lo * kEpsilon;
+  uint64_t result = t0 + t1;
+  if (result < t1) {
+    result += kEpsilon;
+  }
+  return result >= kPrime ? result - kPrime : result;
+}
+
+uint64_t pow_mod(uint64_t base, uint64_t exponent) {
+  uint64_t result = 1;
+  while (exponent != 0) {
+    if (exponent & 1U) {
+      result = multiply_mod(result, base);
+    }
+    base = multiply_mod(base, base);
+    exponent >>= 1;
+  }
+  return result;
+}
+
+uint64_t inverse_mod(uint64_t a) { return pow_mod(a, kPrime - 2); }
+
+// Returns a root of unity of order length, which must be a power of two no
+// larger than 2^32.
+uint64_t root_of_unity(size_t length) {
+  return pow_mod(kGenerator, (kPrime - 1) / length);
+}
+
+// Replaces a[k] by the sum of a[j] * root^(jk) over all j, where root has
+// order n, a power of two.
+void transform(uint64_t* a, size_t n, uint64_t root) {
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      std::swap(a[i], a[j]);
+    }
+  }
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const size_t half = len / 2;
+    const uint64_t step = pow_mod(root, n / len);
+    for (size_t i = 0; i < n; i += len) {
+      uint64_t w = 1;
+      for (size_t j = i; j < i + half; ++j) {
+        const uint64_t u = a[j];
+        const uint64_t v = multiply_mod(a[j + half], w);
+        a[j] = add_mod(u, v);
+        a[j + half] = subtract_mod(u, v);
+        w = multiply_mod(w, step);
+      }
+    }
+  }
+}
+
+// The four step method views a transform of length rows * columns as a row
+// major matrix with x[columns * n1 + n2] in row n1 and column n2. Transforming
+// every column, multiplying entry (k1, n2) by root^(n2 * k1) and transforming
+// every row leaves X[k1 + rows * k2] at position columns * k1 + k2. The
+// entries come out transposed, which does not matter for a convolution as
+// long as the inverse transform undoes the same steps.
+//
+// Rows are transformed in place in the mapped file. Columns are loaded a band
+// of band_width columns at a time, which is what the memory budget limits.
+struct FourStepPlan {
+  size_t rows;
+  size_t columns;
+  size_t band_width;
+};
+
+FourStepPlan plan_transform(size_t length, size_t memory_budget) {
+  const size_t budget_words = std::max<size_t>(memory_budget / 8, 1);
+  FourStepPlan plan{1, length, 1};
+  if (length > budget_words) {
+    plan.columns = 1;
+    while (plan.columns * plan.columns < length) {
+      plan.columns <<= 1;
+    }
+    plan.rows = length / plan.columns;
+  }
+  plan.band_width =
+      std::max<size_t>(1, std::min(plan.columns, budget_words / plan.rows));
+  return plan;
+}
+
+// Transforms every column of x in bands, multiplying entry (k1, n2) by
+// twiddle^(n2 * k1) after the column transform when forward is true and
+// before it otherwise.
+void transform_columns(uint64_t* x, const FourStepPlan& plan, uint64_t root,
+                       uint64_t twiddle, bool forward) {
+  if (plan.rows == 1) {
+    return;
+  }
+  std::vector<uint64_t> band(plan.rows * plan.band_width);
+  std::vector<uint64_t> column(plan.rows);
+  for (size_t first = 0; first < plan.columns; first += plan.band_width) {
+    const size_t width = std::min(plan.band_width, plan.columns - first);
+    for (size_t r = 0; r < plan.rows; ++r) {
+      std::copy_n(x + r * plan.columns + first, width,
+                  band.begin() + r * width);
+    }
+    for (size_t j = 0; j < width; ++j) {
+      const uint64_t step = pow_mod(twiddle, first + j);
+      uint64_t w = 1;
+      for (size_t r = 0; r < plan.rows; ++r) {
+        column[r] = band[r * width + j];
+      }
+      if (forward) {
+        transform(column.data(), plan.rows, root);
+      }
+      for (size_t r = 0; r < plan.rows; ++r) {
+        column[r] = multiply_mod(column[r], w);
+        w = multiply_mod(w, step);
+      }
+      if (!forward) {
+        transform(column.data(), plan.rows, root);
+      }
+      for (size_t r = 0; r < plan.rows; ++r) {
+        band[r * width + j] = column[r];
+      }
+    }
+    for (size_t r = 0; r < plan.rows; ++r) {
+      std::copy_n(band.begin() + r * width, width,
+                  x + r * plan.columns + first);
+    }
+  }
+}
+
+void transform_rows(uint64_t* x, const FourStepPlan& plan, uint64_t root) {
+  for (size_t r = 0; r < plan.rows; ++r) {
+    transform(x + r * plan.columns, plan.columns, root);
+  }
+}
+
+void forward_transform(uint64_t* x, const FourStepPlan& plan) {
+  const uint64_t root = root_of_unity(plan.rows * plan.columns);
+  transform_columns(x, plan, pow_mod(root, plan.columns), root, true);
+  transform_rows(x, plan, pow_mod(root, plan.rows));
+}
+
+// Undoes forward_transform, including the division by the length.
+void inverse_transform(uint64_t* x, const FourStepPlan& plan) {
+  const size_t length = plan.rows * plan.columns;
+  const uint64_t root = inverse_mod(root_of_unity(length));
+  transform_rows(x, plan, pow_mod(root, plan.rows));
+  transform_columns(x, plan, pow_mod(root, plan.columns), root, false);
+  const uint64_t scale = inverse_mod(length);
+  for (size_t i = 0; i < length; ++i) {
+    x[i] = multiply_mod(x[i], scale);
+  }
+}
+
+// Writes the 16 bit halves of the digits to coefficients, padded with zeros
+// to length.
+void split_digits(const uint32_t* digits, size_t num_digits,
+                  uint64_t* coefficients, size_t length) {
+  for (size_t i = 0; i < num_digits; ++i) {
+    coefficients[2 * i] = digits[i] & 0xFFFFU;
+    coefficients[2 * i + 1] = digits[i] >> 16;
+  }
+  std::fill(coefficients + 2 * num_digits, coefficients + length, 0);
+}
+
+// Where temporary files go and how much memory intermediate values may use.
+struct Workspace {
+  std::string near_path;
+  size_t memory_budget;
+};
+
+// A run of zeroed digits, held on the heap if it is small next to the memory
+// budget and in a temporary file otherwise.
+class ScratchDigits {
+ public:
+  ScratchDigits(size_t size, const Workspace& workspace) : count(size) {
+    const size_t allocated = std::max<size_t>(size, 1);
+    if (allocated * sizeof(uint32_t) <= workspace.memory_budget / 8) {
+      memory.resize(allocated, 0);
+      pointer = memory.data();
+    } else {
+      file = std::make_unique<MappedFile>(MappedFile::temporary(
+          workspace.near_path, allocated * sizeof(uint32_t)));
+      pointer = static_cast<uint32_t*>(file->data());
+    }
+  }
+
+  uint32_t* data() const { return pointer; }
+  size_t size() const { return count; }
+
+ private:
+  std::vector<uint32_t> memory;
+  std::unique_ptr<MappedFile> file;
+  uint32_t* pointer;
+  size_t count;
+};
+
+// Writes a * b to out, which has an + bn digits, with the four step transform.
+// Requires an, bn >= 1 and an + bn <= kMaxTotalDigits.
+void transform_multiply(uint32_t* out, const uint32_t* a, size_t an,
+                        const uint32_t* b, size_t bn,
+                        const Workspace& workspace) {
+  const size_t product_digits = an + bn;
+  assert(an >= 1 && bn >= 1 && product_digits <= kMaxTotalDigits);
+  size_t length = 1;
+  while (length < 2 * product_digits) {
+    length <<= 1;
+  }
+  const FourStepPlan plan = plan_transform(length, workspace.memory_budget);
+  const bool square = a == b && an == bn;
+
+  MappedFile x_file =
+      MappedFile::temporary(workspace.near_path, length * sizeof(uint64_t));
+  uint64_t* x = static_cast<uint64_t*>(x_file.data());
+  split_digits(a, an, x, length);
+  forward_transform(x, plan);
+  if (square) {
+    for (size_t i = 0; i < length; ++i) {
+      x[i] = multiply_mod(x[i], x[i]);
+    }
+  } else {
+    MappedFile y_file =
+        MappedFile::temporary(workspace.near_path, length * sizeof(uint64_t));
+    uint64_t* y = static_cast<uint64_t*>(y_file.data());
+    split_digits(b, bn, y, length);
+    forward_transform(y, plan);
+    for (size_t i = 0; i < length; ++i) {
+      x[i] = multiply_mod(x[i], y[i]);
+    }
+  }
+  inverse_transform(x, plan);
+
+  // The coefficients are below 2^63 and the carry below 2^48, so their sum
+  // fits in 64 bits.
+  uint64_t carry = 0;
+  for (size_t i = 0; i < product_digits; ++i) {
+    carry += x[2 * i];
+    const uint32_t low = static_cast<uint32_t>(carry & 0xFFFFU);
+    carry >>= 16;
+    carry += x[2 * i + 1];
+    out[i] = low | static_cast<uint32_t>((carry & 0xFFFFU) << 16);
+    carry >>= 16;
+  }
+  assert(carry == 0);
+}
+
+// Writes a * b to out, which has an + bn digits and must not overlap a or b.
+// Small products are computed in memory and the rest with the transform.
+// Requires an, bn >= 1 and an + bn <= kMaxTotalDigits.
+void multiply_digits(uint32_t* out, const uint32_t* a, size_t an,
+                     const uint32_t* b, size_t bn,
+                     const Workspace& workspace) {
+  if (an < bn) {
+    std::swap(a, b);
+    std::swap(an, bn);
+  }
+  const size_t scratch_size = mpn::mul_scratch_size(an, bn);
+  if (bn >= kTransformMultiplyThreshold ||
+      scratch_size * sizeof(uint32_t) > workspace.memory_budget) {
+    transform_multiply(out, a, an, b, bn, workspace);
+    return;
+  }
+  std::vector<uint32_t> scratch(scratch_size);
+  if (a == b && an == bn) {
+    mpn::sqr(out, a, an, scratch.data());
+  } else {
+    mpn::mul(out, a, an, b, bn, scratch.data());
+  }
+}
+
+// Returns whether a < b, ignoring leading zeros.
+bool less_than(const uint32_t* a, size_t an, const uint32_t* b, size_t bn) {
+  an = mpn::normalized_size(a, an);
+  bn = mpn::normalized_size(b, bn);
+  if (an != bn) {
+    return an < bn;
+  }
+  return mpn::cmp(a, b, an) < 0;
+}
+
+// Writes a natural number in decimal by splitting it recursively at the
+// powers P_k = 10^(9 * kDecimalLeafChunks * 2^k). Each split divides by P_k
+// with Barrett reduction, using floor(B^(2m) / P_k) for B = 2^32 and m the
+// size of P_k. P_(k+1) = P_k^2, and its reciprocal is found by Newton's
+// iteration from the square of the one below. The conversion therefore costs
+// O(log n) multiplications of each size rather than O(n^2) digit operations.
+class DecimalWriter {
+ public:
+  DecimalWriter(std::ostream* output, const Workspace& workspace)
+      : output(output), workspace(workspace) {}
+
+  // Writes the n digit number x without leading zeros. Requires x > 0 and
+  // 2n + 4 <= kMaxTotalDigits.
+  void write(const uint32_t* x, size_t n) {
+    // x < B^n <= P_k^2 once 2(m - 1) >= n.
+    while (levels.empty() || 2 * (levels.back().power_size - 1) < n) {
+      add_level();
+    }
+    write_level(x, n, levels.size(), false);
+  }
+
+ private:
+  struct Level {
+    ScratchDigits power;
+    size_t power_size;
+    ScratchDigits reciprocal;
+    size_t reciprocal_size;
+  };
+
+  std::ostream* output;
+  Workspace workspace;
+  // levels[k] holds P_k and its reciprocal, both without leading zeros.
+  std::vector<Level> levels;
+
+  void add_level() {
+    if (levels.empty()) {
+      add_first_level();
+      return;
+    }
+    const Level& below = levels.back();
+    const size_t m = below.power_size;
+    ScratchDigits power(2 * m, workspace);
+    multiply_digits(power.data(), below.power.data(), m, below.power.data(),
+                    m, workspace);
+    const size_t power_size = mpn::normalized_size(power.data(), 2 * m);
+
+    // With v = floor(B^(2m) / P_k), v^2 / B^(4m - 2M) approximates the new
+    // reciprocal to about m digits, where M is the size of P_(k+1).
+    const size_t vn = below.reciprocal_size;
+    ScratchDigits v_squared(2 * vn, workspace);
+    multiply_digits(v_squared.data(), below.reciprocal.data(), vn,
+                    below.reciprocal.data(), vn, workspace);
+    const size_t shift = 4 * m - 2 * power_size;
+    ScratchDigits reciprocal(power_size + 2, workspace);
+    std::copy(v_squared.data() + shift, v_squared.data() + 2 * vn,
+              reciprocal.data());
+    const size_t reciprocal_size =
+        refine_reciprocal(power.data(), power_size, reciprocal.data());
+    levels.push_back({std::move(power), power_size, std::move(reciprocal),
+                      reciprocal_size});
+  }
+
+  void add_first_level() {
+    Int power = 1;
+    for (size_t i = 0; i < kDecimalLeafChunks; ++i) {
+      power *= static_cast<int32_t>(kDecimalChunk);
+    }
+    const std::vector<uint32_t>& p = power.get_digits();
+    const size_t m = p.size();
+    std::vector<uint32_t> numerator(2 * m + 1, 0);
+    numerator[2 * m] = 1;
+    std::vector<uint32_t> quotient(m + 2);
+    std::vector<uint32_t> remainder(m);
+    std::vector<uint32_t> scratch(mpn::divrem_scratch_size(2 * m + 1, m));
+    mpn::divrem(quotient.data(), remainder.data(), numerator.data(), 2 * m + 1,
+                p.data(), m, scratch.data());
+    const size_t quotient_size =
+        mpn::normalized_size(quotient.data(), quotient.size());
+    Level level{ScratchDigits(m, workspace), m,
+                ScratchDigits(quotient_size, workspace), quotient_size};
+    std::copy(p.begin(), p.end(), level.power.data());
+    std::copy_n(quotient.data(), quotient_size, level.reciprocal.data());
+    levels.push_back(std::move(level));
+  }
+
+  // Replaces w, which has m + 2 digits and approximates floor(B^(2m) / P) to
+  // about half its digits, by that value exactly, and returns its size. The
+  // step w += w (B^(2m) - P w) / B^(2m) squares the relative error, and once
+  // the error is a few units it still moves w by at least one.
+  size_t refine_reciprocal(const uint32_t* p, size_t m, uint32_t* w) const {
+    const size_t w_capacity = m + 2;
+    const uint32_t one = 1;
+    ScratchDigits numerator(2 * m + 1, workspace);
+    numerator.data()[2 * m] = 1;
+    while (true) {
+      const size_t wn = mpn::normalized_size(w, w_capacity);
+      assert(wn > 0);
+      ScratchDigits product(m + wn, workspace);
+      multiply_digits(product.data(), p, m, w, wn, workspace);
+      const size_t product_size = mpn::normalized_size(product.data(), m + wn);
+      const bool too_small = !less_than(numerator.data(), 2 * m + 1,
+                                        product.data(), product_size);
+      // error = |B^(2m) - P w|.
+      const size_t error_capacity = std::max(product_size, 2 * m + 1);
+      ScratchDigits error(error_capacity, workspace);
+      if (too_small) {
+        std::copy_n(numerator.data(), 2 * m + 1, error.data());
+        mpn::sub(error.data(), error.data(), 2 * m + 1, product.data(),
+                 product_size);
+        if (less_than(error.data(), error_capacity, p, m)) {
+          return wn;
+        }
+      } else {
+        std::copy_n(product.data(), product_size, error.data());
+        mpn::sub(error.data(), error.data(), product_size, numerator.data(),
+                 2 * m + 1);
+      }
+      const size_t en = mpn::normalized_size(error.data(), error_capacity);
+      ScratchDigits correction(wn + en, workspace);
+      multiply_digits(correction.data(), w, wn, error.data(), en, workspace);
+      // step = floor(w * error / B^(2m)).
+      const uint32_t* step = correction.data() + 2 * m;
+      const size_t step_size =
+          wn + en > 2 * m ? mpn::normalized_size(step, wn + en - 2 * m) : 0;
+      assert(step_size <= w_capacity);
+      if (too_small) {
+        const uint32_t carry =
+            step_size == 0 ? mpn::add(w, w, w_capacity, &one, 1)
+                           : mpn::add(w, w, w_capacity, step, step_size);
+        assert(carry == 0);
+        static_cast<void>(carry);
+      } else {
+        uint32_t borrow = mpn::sub(w, w, w_capacity, step, step_size);
+        borrow += mpn::sub(w, w, w_capacity, &one, 1);
+        assert(borrow == 0);
+        static_cast<void>(borrow);
+      }
+    }
+  }
+
+  // Writes x < P_level^2 in decimal, padded with leading zeros to
+  // 9 * kDecimalLeafChunks * 2^level digits if padded is true. Level 0 is
+  // the leaf, and level k > 0 splits at levels[k - 1].
+  void write_level(const uint32_t* x, size_t n, size_t level, bool padded) {
+    n = mpn::normalized_size(x, n);
+    if (level == 0) {
+      write_leaf(x, n, padded);
+      return;
+    }
+    const Level& split = levels[level - 1];
+    if (!padded && less_than(x, n, split.power.data(), split.power_size)) {
+      write_level(x, n, level - 1, false);
+      return;
+    }
+    const size_t m = split.power_size;
+    ScratchDigits quotient(m + 1, workspace);
+    ScratchDigits remainder(n, workspace);
+    divide(x, n, split, quotient.data(), remainder.data());
+    write_level(quotient.data(), m + 1, level - 1, padded);
+    write_level(remainder.data(), n, level - 1, true);
+  }
+
+  // Writes x / P to quotient, which has m + 1 digits, and x mod P to
+  // remainder, which has n digits, for x < P^2 with P = split.power of m
+  // digits. Barrett reduction estimates the quotient from the top digits of
+  // x and the reciprocal, undershooting by at most 2.
+  void divide(const uint32_t* x, size_t n, const Level& split,
+              uint32_t* quotient, uint32_t* remainder) const {
+    const uint32_t* p = split.power.data();
+    const size_t m = split.power_size;
+    std::copy_n(x, n, remainder);
+    if (n < m) {
+      return;
+    }
+    {
+      // quotient = floor(floor(x / B^(m - 1)) * reciprocal / B^(m + 1)).
+      const size_t top_size = n - (m - 1);
+      const size_t vn = split.reciprocal_size;
+      ScratchDigits estimate(top_size + vn, workspace);
+      multiply_digits(estimate.data(), x + (m - 1), top_size,
+                      split.reciprocal.data(), vn, workspace);
+      if (top_size + vn > m + 1) {
+        std::copy(estimate.data() + m + 1, estimate.data() + top_size + vn,
+                  quotient);
+      }
+    }
+    const size_t qn = mpn::normalized_size(quotient, m + 1);
+    if (qn > 0) {
+      ScratchDigits product(qn + m, workspace);
+      multiply_digits(product.data(), quotient, qn, p, m, workspace);
+      const size_t product_size = mpn::normalized_size(product.data(), qn + m);
+      assert(product_size <= n);
+      const uint32_t borrow =
+          mpn::sub(remainder, remainder, n, product.data(), product_size);
+      assert(borrow == 0);
+      static_cast<void>(borrow);
+    }
+    const uint32_t one = 1;
+    while (!less_than(remainder, n, p, m)) {
+      mpn::sub(remainder, remainder, n, p, m);
+      mpn::add(quotient, quotient, m + 1, &one, 1);
+    }
+  }
+
+  // Writes x < 10^(9 * kDecimalLeafChunks) by repeated division by 10^9.
+  void write_leaf(const uint32_t* x, size_t n, bool padded) {
+    std::vector<uint32_t> work(x, x + n);
+    uint32_t chunks[kDecimalLeafChunks];
+    for (uint32_t& chunk : chunks) {
+      chunk = n == 0 ? 0
+                     : mpn::divrem_1(work.data(), work.data(), n,
+                                     kDecimalChunk);
+      n = mpn::normalized_size(work.data(), n);
+    }
+    assert(n == 0);
+    size_t i = kDecimalLeafChunks;
+    if (!padded) {
+      while (i > 0 && chunks[i - 1] == 0) {
+        --i;
+      }
+      assert(i > 0);
+      --i;
+      *output << chunks[i];
+    }
+    char buffer[kDecimalChunkDigits + 1];
+    for (; i > 0; --i) {
+      std::snprintf(buffer, sizeof(buffer), "%09u", chunks[i - 1]);
+      output->write(buffer, kDecimalChunkDigits);
+    }
+  }
+};
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path, size_t bytes, bool keep_size)
+    : fd(-1), bytes(bytes), address(nullptr) {
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    throw system_error("cannot open " + path);
+  }
+  if (keep_size) {
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw system_error("cannot stat " + path);
+    }
+    this->bytes = static_cast<size_t>(info.st_size);
+  } else if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    ::close(fd);
+    throw system_error("cannot resize " + path);
+  }
+  map();
+}
+
+MappedFile::MappedFile(int fd, size_t bytes, const std::string& path)
+    : fd(fd), bytes(bytes), address(nullptr) {
+  if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    ::close(fd);
+    this->fd = -1;
+    throw system_error("cannot resize " + path);
+  }
+  map();
+}
+
+MappedFile MappedFile::temporary(const std::string& near_path, size_t bytes) {
+  std::string path = near_path + ".XXXXXX";
+  // mkstemp creates the file with O_EXCL, so the name unlinked below is the
+  // one just created.
+  const int fd = ::mkstemp(&path[0]);
+  if (fd < 0) {
+    throw system_error("cannot create a temporary file for " + near_path);
+  }
+  if (::unlink(path.c_str()) != 0) {
+    ::close(fd);
+    throw system_error("cannot unlink " + path);
+  }
+  return MappedFile(fd, bytes, path);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : fd(other.fd), bytes(other.bytes), address(other.address) {
+  other.fd = -1;
+  other.bytes = 0;
+  other.address = nullptr;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    fd = other.fd;
+    bytes = other.bytes;
+    address = other.address;
+    other.fd = -1;
+    other.bytes = 0;
+    other.address = nullptr;
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  unmap();
+  if (fd >= 0) {
+    ::close(fd);
+  }
+}
+
+void MappedFile::resize(size_t new_bytes) {
+  unmap();
+  if (::ftruncate(fd, static_cast<off_t>(new_bytes)) != 0) {
+    throw system_error("cannot resize mapped file");
+  }
+  bytes = new_bytes;
+  map();
+}
+
+void MappedFile::map() {
+  if (bytes == 0) {
+    address = nullptr;
+    return;
+  }
+  address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (address == MAP_FAILED) {
+    address = nullptr;
+    throw system_error("cannot map file");
+  }
+}
+
+void MappedFile::unmap() {
+  if (address != nullptr) {
+    ::munmap(address, bytes);
+    address = nullptr;
+  }
+}
+
+DiskInt::DiskInt(MappedFile file, size_t num_digits)
+    : file(std::move(file)), num_digits(num_digits) {}
+
+DiskInt DiskInt::create(const std::string& path, const Int& value) {
+  if (value.sign() < 0) {
+    throw std::invalid_argument("DiskInt cannot hold a negative value");
+  }
+  const std::vector<uint32_t>& value_digits = value.get_digits();
+  DiskInt result(MappedFile(path, value_digits.size() * sizeof(uint32_t)),
+                 value_digits.size());
+  std::copy(value_digits.begin(), value_digits.end(), result.digits());
+  return result;
+}
+
+DiskInt DiskInt::open(const std::string& path) {
+  MappedFile file(path, 0, true);
+  if (file.size() % sizeof(uint32_t) != 0) {
+    throw std::invalid_argument(path + " does not hold whole digits");
+  }
+  const size_t num_digits = file.size() / sizeof(uint32_t);
+  return DiskInt(std::move(file), num_digits);
+}
+
+Int DiskInt::to_int() const { return slice(0, num_digits); }
+
+Int DiskInt::slice(size_t begin, size_t count) const {
+  assert(begin + count <= num_digits);
+  if (count == 0) {
+    return 0;
+  }
+  return Int(std::vector<uint32_t>(digits() + begin, digits() + begin + count));
+}
+
+DiskInt& DiskInt::operator+=(const DiskInt& rhs) {
+  const size_t rhs_digits = rhs.num_digits;
+  const size_t sum_digits = std::max(num_digits, rhs_digits) + 1;
+  // Growing the file fills the new digits with zeros. rhs may be *this, so
+  // its digits are only looked up after the remap.
+  file.resize(sum_digits * sizeof(uint32_t));
+  uint32_t* out = digits();
+  const uint32_t* in = rhs.digits();
+  uint64_t carry = 0;
+  for (size_t i = 0; i + 1 < sum_digits; ++i) {
+    carry += out[i];
+    if (i < rhs_digits) {
+      carry += in[i];
+    }
+    out[i] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  out[sum_digits - 1] = static_cast<uint32_t>(carry);
+  num_digits = carry == 0 ? sum_digits - 1 : sum_digits;
+  if (num_digits != sum_digits) {
+    file.resize(num_digits * sizeof(uint32_t));
+  }
+  return *this;
+}
+
+DiskInt DiskInt::multiply(const DiskInt& a, const DiskInt& b,
+                          const std::string& path, size_t memory_budget) {
+  const size_t product_digits = a.num_digits + b.num_digits;
+  if (product_digits > kMaxTotalDigits) {
+    throw std::invalid_argument("DiskInt operands are too large to multiply");
+  }
+  DiskInt result(MappedFile(path, product_digits * sizeof(uint32_t)),
+                 product_digits);
+  if (a.num_digits == 0 || b.num_digits == 0) {
+    return result;
+  }
+  transform_multiply(result.digits(), a.digits(), a.num_digits, b.digits(),
+                     b.num_digits, Workspace{path, memory_budget});
+  return result;
+}
+
+void DiskInt::write_decimal(const std::string& path,
+                            size_t memory_budget) const {
+  const size_t n = mpn::normalized_size(digits(), num_digits);
+  if (2 * n + 4 > kMaxTotalDigits) {
+    throw std::invalid_argument("DiskInt is too large to convert to decimal");
+  }
+  std::ofstream output(path, std::ios::binary);
+  if (!output) {
+    throw std::runtime_error("cannot open " + path);
+  }
+  if (n == 0) {
+    output << '0';
+  } else {
+    DecimalWriter(&output, Workspace{path, memory_budget}).write(digits(), n);
+  }
+  if (!output) {
+    throw std::runtime_error("cannot write " + path);
+  }
+}
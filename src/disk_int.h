@@ -0,0 +1,94 @@
+#ifndef NUMBER_SRC_DISK_INT_H
+#define NUMBER_SRC_DISK_INT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "integer.h"
+
+// A file mapped into memory with mmap. The mapping is shared, so writes go
+// to the file and the kernel can page the contents out under memory
+// pressure.
+class MappedFile {
+ public:
+  // Opens path, creating it if needed, and sets its size to bytes unless
+  // keep_size is true. Throws std::runtime_error on failure.
+  MappedFile(const std::string& path, size_t bytes, bool keep_size = false);
+  // Creates a new file of bytes in the directory of near_path with a unique
+  // name from mkstemp, and unlinks it at once, so it disappears when unmapped
+  // and no existing file is touched. Throws std::runtime_error on failure.
+  static MappedFile temporary(const std::string& near_path, size_t bytes);
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  void resize(size_t bytes);
+  size_t size() const { return bytes; }
+  void* data() const { return address; }
+
+ private:
+  int fd;
+  size_t bytes;
+  void* address;
+
+  // Takes ownership of the open file fd, resizes it to bytes and maps it.
+  MappedFile(int fd, size_t bytes, const std::string& path);
+
+  void map();
+  void unmap();
+};
+
+// A nonnegative integer whose base 2^32 digits live in a file rather than on
+// the heap, for values too large to hold in memory. Every operation streams
+// through the digits in passes and keeps at most a caller supplied number of
+// bytes of working memory, apart from the pages of the mapped files that the
+// kernel chooses to keep resident.
+class DiskInt {
+ public:
+  // Writes value to a new file at path. Throws std::invalid_argument if value
+  // is negative.
+  static DiskInt create(const std::string& path, const Int& value);
+  // Maps an existing file written by create() or one of the operations below.
+  static DiskInt open(const std::string& path);
+
+  // Number of digits, which may include leading zeros.
+  size_t size() const { return num_digits; }
+  // Reads the whole value into memory.
+  Int to_int() const;
+  // Returns the count digits starting at digit begin as an Int.
+  Int slice(size_t begin, size_t count) const;
+
+  // Adds rhs to *this in a single streamed pass.
+  DiskInt& operator+=(const DiskInt& rhs);
+
+  // Returns a * b, written to a new file at path. The product is computed
+  // with a number theoretic transform modulo 2^64 - 2^32 + 1 using the four
+  // step method, so each pass only holds one row or one band of columns of
+  // the transform in memory. The operands may have at most 2^31 digits in
+  // total; throws std::invalid_argument otherwise.
+  static DiskInt multiply(const DiskInt& a, const DiskInt& b,
+                          const std::string& path,
+                          size_t memory_budget = size_t{64} << 20);
+
+  // Writes the value in decimal to the file at path. The value is split
+  // recursively at powers of 10^9 and each split divides with a precomputed
+  // reciprocal, so the conversion costs O(log size()) multiplications of each
+  // size. Intermediate values beyond a fraction of memory_budget live in
+  // temporary files next to path. The value may have at most 2^30 - 2
+  // significant digits; throws std::invalid_argument otherwise.
+  void write_decimal(const std::string& path,
+                     size_t memory_budget = size_t{64} << 20) const;
+
+ private:
+  DiskInt(MappedFile file, size_t num_digits);
+
+  MappedFile file;
+  size_t num_digits;
+
+  uint32_t* digits() const { return static_cast<uint32_t*>(file.data()); }
+};
+
+#endif  // NUMBER_SRC_DISK_INT_H
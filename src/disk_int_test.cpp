@@ -0,0 +1,166 @@
+#include "disk_int.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "integer.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "gtest/gtest.h"
+#pragma clang diagnostic pop
+
+namespace {
+std::string temp_path(const std::string& name) {
+  const char* dir = std::getenv("TEST_TMPDIR");
+  return std::string(dir != nullptr ? dir : "/tmp") + "/disk_int_test_" + name;
+}
+
+Int random_int(std::mt19937* gen, size_t num_digits) {
+  std::vector<uint32_t> digits(num_digits);
+  for (uint32_t& digit : digits) {
+    digit = (*gen)();
+  }
+  digits.back() |= 1;
+  return Int(digits);
+}
+
+std::string read_file(const std::string& path) {
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+}  // namespace
+
+TEST(DiskIntTest, RoundTrip) {
+  const Int a{"340282366920938463463374607431768211457"};
+  {
+    DiskInt disk = DiskInt::create(temp_path("round_trip"), a);
+    EXPECT_EQ(disk.size(), 5);
+    EXPECT_EQ(disk.to_int(), a);
+    EXPECT_EQ(disk.slice(0, 1), 1);
+    EXPECT_EQ(disk.slice(4, 1), 1);
+    EXPECT_EQ(disk.slice(1, 3), 0);
+  }
+  EXPECT_EQ(DiskInt::open(temp_path("round_trip")).to_int(), a);
+  EXPECT_THROW(DiskInt::create(temp_path("negative"), -a),
+               std::invalid_argument);
+}
+
+TEST(DiskIntTest, Addition) {
+  std::mt19937 gen(1);
+  const Int a = random_int(&gen, 300);
+  const Int b = random_int(&gen, 120);
+  DiskInt disk_a = DiskInt::create(temp_path("add_a"), a);
+  const DiskInt disk_b = DiskInt::create(temp_path("add_b"), b);
+  disk_a += disk_b;
+  EXPECT_EQ(disk_a.to_int(), a + b);
+  disk_a += disk_a;
+  EXPECT_EQ(disk_a.to_int(), (a + b) * 2);
+
+  const Int max_digit{"4294967295"};
+  DiskInt carry = DiskInt::create(temp_path("add_carry"), max_digit);
+  carry += DiskInt::create(temp_path("add_one"), 1);
+  EXPECT_EQ(carry.size(), 2);
+  EXPECT_EQ(carry.to_int(), max_digit + 1);
+}
+
+TEST(DiskIntTest, Multiplication) {
+  std::mt19937 gen(2);
+  const Int a = random_int(&gen, 700);
+  const Int b = random_int(&gen, 333);
+  const DiskInt disk_a = DiskInt::create(temp_path("mul_a"), a);
+  const DiskInt disk_b = DiskInt::create(temp_path("mul_b"), b);
+  // A transform of 4096 entries with room for 256 of them in memory takes
+  // several bands of columns.
+  for (const size_t budget : {size_t{2048}, size_t{1} << 20}) {
+    EXPECT_EQ(
+        DiskInt::multiply(disk_a, disk_b, temp_path("mul_ab"), budget).to_int(),
+        a * b);
+    EXPECT_EQ(
+        DiskInt::multiply(disk_a, disk_a, temp_path("mul_aa"), budget).to_int(),
+        a * a);
+  }
+  const DiskInt zero = DiskInt::create(temp_path("mul_zero"), 0);
+  EXPECT_EQ(DiskInt::multiply(disk_a, zero, temp_path("mul_a0")).to_int(), 0);
+
+  const Int max_digits{
+      "115792089237316195423570985008687907853269984665640564039457584007913"
+      "129639935"};
+  const DiskInt disk_max = DiskInt::create(temp_path("mul_max"), max_digits);
+  EXPECT_EQ(
+      DiskInt::multiply(disk_max, disk_max, temp_path("mul_max2"), 64).to_int(),
+      max_digits * max_digits);
+}
+
+TEST(DiskIntTest, WriteDecimal) {
+  const std::string decimal =
+      "1000000000000000000000000000000000000000000000000000000001230000000045";
+  DiskInt disk = DiskInt::create(temp_path("decimal"), Int(decimal));
+  disk.write_decimal(temp_path("decimal.txt"));
+  EXPECT_EQ(read_file(temp_path("decimal.txt")), decimal);
+
+  DiskInt::create(temp_path("decimal_zero"), 0)
+      .write_decimal(temp_path("decimal_zero.txt"));
+  EXPECT_EQ(read_file(temp_path("decimal_zero.txt")), "0");
+
+  std::mt19937 gen(3);
+  const Int a = random_int(&gen, 200);
+  DiskInt::create(temp_path("decimal_random"), a)
+      .write_decimal(temp_path("decimal_random.txt"));
+  EXPECT_EQ(read_file(temp_path("decimal_random.txt")), a.print());
+
+  // Powers of ten and their neighbours around the split points 10^288,
+  // 10^576 and 10^1152, where the quotients and the padding of remainders
+  // are most likely to go wrong.
+  for (const size_t zeros : {287, 288, 289, 576, 1152, 1153, 2000}) {
+    const std::string power = "1" + std::string(zeros, '0');
+    const std::string nines(zeros, '9');
+    const std::string sparse = "7" + std::string(zeros, '0') + "1";
+    for (const std::string& decimal : {power, nines, sparse}) {
+      DiskInt::create(temp_path("decimal_power"), Int(decimal))
+          .write_decimal(temp_path("decimal_power.txt"));
+      EXPECT_EQ(read_file(temp_path("decimal_power.txt")), decimal) << zeros;
+    }
+  }
+}
+
+TEST(DiskIntTest, WriteDecimalOutOfCore) {
+  // A budget of a few kilobytes keeps intermediate values in temporary files
+  // and multiplies them with the transform.
+  std::mt19937 gen(5);
+  for (const size_t num_digits : {31, 500, 3000}) {
+    const Int a = random_int(&gen, num_digits);
+    const DiskInt disk = DiskInt::create(temp_path("decimal_large"), a);
+    for (const size_t budget : {size_t{4096}, size_t{64} << 20}) {
+      disk.write_decimal(temp_path("decimal_large.txt"), budget);
+      EXPECT_EQ(read_file(temp_path("decimal_large.txt")), a.print())
+          << num_digits << " " << budget;
+    }
+  }
+}
+
+TEST(DiskIntTest, ScratchFilesAreUnique) {
+  // Files named like the scratch files of old versions are left alone.
+  const std::string out = temp_path("scratch_out");
+  for (const std::string suffix : {".scratch0", ".scratch1"}) {
+    std::ofstream(out + suffix) << "keep";
+  }
+  std::mt19937 gen(4);
+  const Int a = random_int(&gen, 50);
+  const Int b = random_int(&gen, 40);
+  const DiskInt disk_a = DiskInt::create(temp_path("scratch_a"), a);
+  const DiskInt disk_b = DiskInt::create(temp_path("scratch_b"), b);
+  EXPECT_EQ(DiskInt::multiply(disk_a, disk_b, out).to_int(), a * b);
+  disk_a.write_decimal(out);
+  EXPECT_EQ(read_file(out), a.print());
+  for (const std::string suffix : {".scratch0", ".scratch1"}) {
+    EXPECT_EQ(read_file(out + suffix), "keep");
+  }
+}
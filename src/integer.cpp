@@ -1,14 +1,21 @@
 #include "integer.h"
 
+#include "integer_tuning.h"
+#include "mpn.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
 
 namespace {
 template <typename T>
@@ -20,22 +27,46 @@ std::ostream& operator<<(std::ostream& out, const std::vector<T>& v) {
   }
   return out;
 }
+
+// Returns a * b, possibly with leading zeros.
+std::vector<uint32_t> multiply_digits(const std::vector<uint32_t>& a,
+                                      const std::vector<uint32_t>& b) {
+  if (a.size() < b.size()) {
+    return multiply_digits(b, a);
+  }
+  std::vector<uint32_t> result(a.size() + b.size());
+  std::vector<uint32_t> scratch(mpn::mul_scratch_size(a.size(), b.size()));
+  mpn::mul(result.data(), a.data(), a.size(), b.data(), b.size(),
+           scratch.data());
+  return result;
+}
+
+std::vector<uint32_t> square_digits(const std::vector<uint32_t>& a) {
+  std::vector<uint32_t> result(2 * a.size());
+  std::vector<uint32_t> scratch(mpn::sqr_scratch_size(a.size()));
+  mpn::sqr(result.data(), a.data(), a.size(), scratch.data());
+  return result;
+}
 }  // namespace
 
-Int::Int(int32_t a) {
-  static_assert(
-      static_cast<uint32_t>(-1) == static_cast<uint32_t>(0xFFFFFFFFULL),
-      "Your compiler must use two's complement.");
+Int::Int(int32_t a)
+    : is_negative(a < 0),
+      // Negating in uint32_t is exact even for the most negative value.
+      digits({a < 0 ? 0U - static_cast<uint32_t>(a)
+                    : static_cast<uint32_t>(a)}) {}
 
-  if (a == std::numeric_limits<int32_t>::min()) {  // Deal with special case.
-    is_negative = true;
-    digits.push_back(0x80000000ULL);
-    return;
-  }
+Int::Int(Int&& other) noexcept
+    : is_negative(other.is_negative), digits(std::move(other.digits)) {
+  other.is_negative = false;
+}
 
-  is_negative = a < 0;
-  int32_t abs_a = is_negative ? -a : a;
-  digits.push_back(abs_a);
+Int& Int::operator=(Int&& other) noexcept {
+  // In this order, moving an Int into itself leaves it unchanged.
+  const bool negative = other.is_negative;
+  other.is_negative = false;
+  digits = std::move(other.digits);
+  is_negative = negative;
+  return *this;
 }
 
 Int::Int(std::string a) {
@@ -43,26 +74,25 @@ Int::Int(std::string a) {
   if (a.empty()) {
     throw std::invalid_argument("string must be nonempty");
   }
-  if (a == "-0") {
-    is_negative = false;
-    digits.push_back(0);
-    return;
-  }
 
-  auto numeric_start_it = a.begin();
-  if (a[0] == '-') {
-    ++numeric_start_it;
-  }
-  digits.push_back(0);
-  for (auto it = numeric_start_it; it != a.end(); ++it) {
-    char c = *it;
-    if (!isdigit(c)) {
+  const size_t numeric_start = a[0] == '-' ? 1 : 0;
+  for (size_t i = numeric_start; i < a.size(); ++i) {
+    if (!isdigit(a[i])) {
       throw std::invalid_argument("string must be numeric");
     }
-    *this *= Int(10);
-    *this += Int(c - '0');
   }
-  is_negative = (a[0] == '-');
+  digits = SharedDigits(decimal_to_digits(
+      a.substr(numeric_start), kFromDecimalDivideAndConquerThreshold));
+  remove_leading_zeros();
+  is_negative = numeric_start == 1 && !is_zero();
+}
+
+Int::Int(std::vector<uint32_t> a, bool negative)
+    : is_negative(negative), digits(std::move(a)) {
+  remove_leading_zeros();
+  if (is_zero()) {
+    is_negative = false;
+  }
 }
 
 bool operator<(const Int& lhs, const Int& rhs) {
@@ -86,20 +116,11 @@ bool operator==(const Int& lhs, const Int& rhs) {
 }
 
 bool less_in_magnitude(const Int& lhs, const Int& rhs) {
-  if (lhs.digits.size() < rhs.digits.size()) {
-    return true;
-  } else if (lhs.digits.size() > rhs.digits.size()) {
-    return false;
-  } else {
-    for (int i = lhs.digits.size() - 1; i >= 0; --i) {
-      if (lhs.digits[i] < rhs.digits[i]) {
-        return true;
-      } else if (lhs.digits[i] > rhs.digits[i]) {
-        return false;
-      }
-    }
-    return false;
+  if (lhs.digits.size() != rhs.digits.size()) {
+    return lhs.digits.size() < rhs.digits.size();
   }
+  return mpn::cmp(lhs.digits.get().data(), rhs.digits.get().data(),
+                  lhs.digits.size()) < 0;
 }
 
 Int& Int::operator+=(const Int& rhs) {
@@ -115,7 +136,7 @@ Int& Int::operator+=(const Int& rhs) {
     *this = rhs;
     subtract_ignoring_sign(temp);
   }
-  if (digits.size() == 1 && digits[0] == 0) {
+  if (is_zero()) {
     is_negative = false;
   }
   return *this;
@@ -127,30 +148,28 @@ Int& Int::operator-=(const Int& rhs) {
 }
 
 Int& Int::operator*=(const Int& rhs) {
-  Int result = 0;
-  for (int i = 0; i < rhs.digits.size(); ++i) {
-    Int single_multiplication = multiply_ignoring_sign(*this, rhs.digits[i]);
-    single_multiplication.shift_by(i);
-    result += single_multiplication;
-  }
-  result.is_negative = is_negative;
-  *this = result;
-  is_negative ^= rhs.is_negative;
-  if (digits.size() == 1 && digits[0] == 0) {
-    is_negative = false;
+  const bool result_is_negative = is_negative ^ rhs.is_negative;
+  // Copies share their digits, so this also catches x * y where y is a copy
+  // of x.
+  if (&digits.get() == &rhs.digits.get()) {
+    digits = SharedDigits(square_digits(digits.get()));
+  } else {
+    digits = SharedDigits(multiply_digits(digits.get(), rhs.digits.get()));
   }
+  remove_leading_zeros();
+  is_negative = result_is_negative && !is_zero();
   return *this;
 }
 
 Int& Int::operator/=(const Int& rhs) {
-  // Only implemented for positive integers, where the result is positive.
-  Int internal_rhs = rhs;
-  const bool this_is_negative = is_negative;
-  const bool rhs_is_negative = internal_rhs.is_negative;
-  is_negative = false;
-  internal_rhs.is_negative = false;
-  divide_ignoring_sign(internal_rhs);
-  is_negative = this_is_negative ^ rhs_is_negative;
+  const bool result_is_negative = is_negative ^ rhs.is_negative;
+  if (rhs.digits.size() == 1) {
+    // Single digit divisors avoid the general algorithm entirely.
+    divmod_ui(rhs.digits[0]);
+  } else {
+    divide_ignoring_sign(rhs);
+  }
+  is_negative = result_is_negative && !is_zero();
   return *this;
 }
 
@@ -165,111 +184,68 @@ Int Int::operator-() const {
 
 std::string Int::debug_string() const {
   std::ostringstream out;
-  out << (sign() == 1 ? "+" : "-") << digits;
+  out << (sign() == 1 ? "+" : "-") << digits.get();
   return out.str();
 }
 
-void Int::borrow_from_neighbour(int neighbour) {
-  assert(neighbour < digits.size());
-  while (digits[neighbour] == 0) {
-    digits[neighbour] = std::numeric_limits<uint32_t>::max();
-    ++neighbour;
-    assert(neighbour < digits.size());
-  }
-  --digits[neighbour];
-}
-
 void Int::add_ignoring_sign(const Int& rhs) {
-  uint32_t carry = 0;
-  int i = 0;
-  while (i < std::max(digits.size(), rhs.digits.size()) || carry != 0) {
-    // First ensure that there is a place to store the next digit.
-    if (i >= digits.size()) {
-      digits.push_back(0);
-      assert(i == digits.size() - 1);
-    }
-
-    std::tie(digits[i], carry) = add_with_carry(
-        digits[i], i < rhs.digits.size() ? rhs.digits[i] : 0, carry);
-    ++i;
+  const size_t rhs_size = rhs.digits.size();
+  std::vector<uint32_t>& sum = digits.mutate();
+  // If rhs is *this the sizes are equal, so its digits are not moved.
+  if (sum.size() < rhs_size) {
+    sum.resize(rhs_size, 0);
+  }
+  const uint32_t carry = mpn::add(sum.data(), sum.data(), sum.size(),
+                                  rhs.digits.get().data(), rhs_size);
+  if (carry != 0) {
+    sum.push_back(carry);
   }
 }
 
 void Int::subtract_ignoring_sign(const Int& rhs) {
   assert(!less_in_magnitude(*this, rhs));
-  for (int i = 0; i < digits.size(); ++i) {
-    uint32_t curr_rhs_digit = i < rhs.digits.size() ? rhs.digits[i] : 0;
-    if (digits[i] < curr_rhs_digit) {
-      borrow_from_neighbour(i + 1);
-    }
-    digits[i] -= curr_rhs_digit;
-  }
+  const size_t rhs_size = rhs.digits.size();
+  std::vector<uint32_t>& difference = digits.mutate();
+  const uint32_t borrow =
+      mpn::sub(difference.data(), difference.data(), difference.size(),
+               rhs.digits.get().data(), rhs_size);
+  assert(borrow == 0);
+  static_cast<void>(borrow);
   remove_leading_zeros();
 }
 
 void Int::remove_leading_zeros() {
-  while (digits.size() > 0 && digits.back() == 0) {
-    digits.pop_back();
+  // Read through the const digits first so that they are only copied when
+  // one of them is actually removed.
+  const std::vector<uint32_t>& const_digits = digits.get();
+  const size_t size =
+      std::max<size_t>(mpn::normalized_size(const_digits.data(),
+                                            const_digits.size()),
+                       1);
+  if (size != const_digits.size()) {
+    digits.mutate().resize(size);
   }
-  if (digits.empty()) {
-    digits.push_back(0);
-  }
-}
-
-Int Int::multiply_ignoring_sign(Int x, const uint32_t y) {
-  x.is_negative = false;
-  uint32_t carry = 0;
-  for (int i = 0; i < x.digits.size(); ++i) {
-    std::tie(x.digits[i], carry) = multiply_with_carry(x.digits[i], y, carry);
-  }
-  if (carry != 0) {
-    x.digits.push_back(carry);
-  }
-  return x;
 }
 
-void Int::divide_ignoring_sign(const Int& rhs) {
-  // Assumes that *this is nonegative and and rhs is positive.
-  assert(rhs != 0);
-  if (*this < rhs) {
+Int Int::divide_ignoring_sign(const Int& rhs) {
+  assert(!rhs.is_zero());
+  const std::vector<uint32_t>& a = digits.get();
+  const std::vector<uint32_t>& d = rhs.digits.get();
+  if (a.size() < d.size()) {
+    Int remainder = *this;
+    remainder.is_negative = false;
     *this = 0;
-    return;
-  }
-  Int lo{0};
-  Int hi{1};
-  hi.shift_by(digits.size() - rhs.digits.size() + 1);
-  Int ans{0};
-  int i = 0;
-  while (lo <= hi) {
-    ++i;
-    Int mid = lo + hi;
-    mid.divide_by_2();
-    if (mid * rhs == *this) {
-      *this = mid;
-      return;
-    } else if (*this < mid * rhs) {
-      hi = mid - 1;
-    } else if (*this > mid * rhs) {
-      lo = mid + 1;
-      ans = mid;
-    }
-  }
-  *this = ans;
-}
-
-void Int::divide_by_2() {
-  assert(digits.size() != 0);
-  if (digits.size() == 1) {
-    digits[0] >>= 1;
-    return;
+    return remainder;
   }
-  for (int i = 1; i < digits.size(); ++i) {
-    digits[i - 1] >>= 1;
-    uint32_t lsb = digits[i] & 1U;
-    digits[i - 1] |= (lsb << 31);
-  }
-  digits[digits.size() - 1] >>= 1;
+  std::vector<uint32_t> quotient(a.size() - d.size() + 1);
+  std::vector<uint32_t> remainder(d.size());
+  std::vector<uint32_t> scratch(mpn::divrem_scratch_size(a.size(), d.size()));
+  mpn::divrem(quotient.data(), remainder.data(), a.data(), a.size(), d.data(),
+              d.size(), scratch.data());
+  digits = SharedDigits(std::move(quotient));
+  is_negative = false;
   remove_leading_zeros();
+  return Int(std::move(remainder));
 }
 
 // Multiply by (2^32)^i.
@@ -279,16 +255,16 @@ void Int::shift_by(int i) {
     return;
   }
 
-  for (int j = 0; j < i; ++j) {
-    digits.push_back(0);
-  }
-
-  std::rotate(digits.rbegin(), digits.rbegin() + i, digits.rend());
+  std::vector<uint32_t>& mutable_digits = digits.mutate();
+  mutable_digits.insert(mutable_digits.begin(), i, 0);
 }
 
 Int Int::mod(const Int& rhs) const {
   assert(rhs > 0);
-  return *this - rhs * (*this / rhs);
+  Int quotient = *this;
+  const Int remainder = quotient.divide_ignoring_sign(rhs);
+  // The remainder takes the sign of *this, as with truncating division.
+  return is_negative ? -remainder : remainder;
 }
 
 Int& Int::reduce_mod(const Int& rhs) {
@@ -301,25 +277,111 @@ std::string Int::print() const {
   if (*this == 0) {
     return "0";
   }
-  std::string result;
+  // Peel off nine decimal digits at a time, least significant first.
+  const DigitDivisor billion(1000000000);
+  std::vector<uint32_t> chunks;
   Int this_copy = *this;
   this_copy.is_negative = false;
   while (this_copy != 0) {
-    Int next_digit = this_copy.mod(10);
-    for (int i = 0; i < 10; ++i) {
-      if (i == next_digit) {
-        result += std::to_string(i);
-      }
-    }
-    this_copy /= 10;
+    chunks.push_back(this_copy.divmod_ui(billion));
   }
-  if (is_negative) {
-    result += "-";
+  std::string result = is_negative ? "-" : "";
+  result += std::to_string(chunks.back());
+  for (int i = static_cast<int>(chunks.size()) - 2; i >= 0; --i) {
+    const std::string chunk = std::to_string(chunks[i]);
+    result.append(9 - chunk.size(), '0');
+    result += chunk;
   }
-  std::reverse(result.begin(), result.end());
   return result;
 }
 
+uint32_t Int::divmod_ui(uint32_t d) { return divmod_ui(DigitDivisor(d)); }
+
+uint32_t Int::divmod_ui(const DigitDivisor& d) {
+  // Divide digits << shift by the normalized divisor; the quotient is
+  // unchanged and the remainder comes out shifted by the same amount.
+  std::vector<uint32_t>& a = digits.mutate();
+  const int s = d.shift();
+  uint32_t remainder = s == 0 ? 0 : a.back() >> (32 - s);
+  for (int i = static_cast<int>(a.size()) - 1; i >= 0; --i) {
+    uint32_t next = a[i] << s;
+    if (s != 0 && i > 0) {
+      next |= a[i - 1] >> (32 - s);
+    }
+    std::tie(a[i], remainder) = d.divide_normalized(remainder, next);
+  }
+  remove_leading_zeros();
+  if (is_zero()) {
+    is_negative = false;
+  }
+  return remainder >> s;
+}
+
+uint64_t Int::divmod_ui64(uint64_t d) {
+  if (d <= std::numeric_limits<uint32_t>::max()) {
+    return divmod_ui(static_cast<uint32_t>(d));
+  }
+  std::vector<uint32_t>& a = digits.mutate();
+  unsigned __int128 remainder = 0;
+  for (int i = static_cast<int>(a.size()) - 1; i >= 0; --i) {
+    const unsigned __int128 current = (remainder << 32) | a[i];
+    a[i] = static_cast<uint32_t>(current / d);
+    remainder = current % d;
+  }
+  remove_leading_zeros();
+  if (is_zero()) {
+    is_negative = false;
+  }
+  return static_cast<uint64_t>(remainder);
+}
+
+uint32_t Int::mod_ui(const DigitDivisor& d) const {
+  const int s = d.shift();
+  uint32_t remainder = s == 0 ? 0 : digits.back() >> (32 - s);
+  for (int i = static_cast<int>(digits.size()) - 1; i >= 0; --i) {
+    uint32_t next = digits[i] << s;
+    if (s != 0 && i > 0) {
+      next |= digits[i - 1] >> (32 - s);
+    }
+    remainder = d.divide_normalized(remainder, next).second;
+  }
+  return remainder >> s;
+}
+
+DigitDivisor::DigitDivisor(uint32_t d)
+    : d(d), d_normalized(d), normalizing_shift(0) {
+  if (d == 0) {
+    throw std::domain_error("division by zero");
+  }
+  while ((d_normalized & 0x80000000U) == 0) {
+    d_normalized <<= 1;
+    ++normalizing_shift;
+  }
+  reciprocal = static_cast<uint32_t>(0xFFFFFFFFFFFFFFFFULL / d_normalized -
+                                     0x100000000ULL);
+}
+
+std::pair<uint32_t, uint32_t> DigitDivisor::divide_normalized(
+    uint32_t hi, uint32_t lo) const {
+  assert(hi < d_normalized);
+  // Estimate the quotient as hi * reciprocal + (hi, lo), which is off by at
+  // most one in either direction, then correct it with two cheap branches.
+  const uint64_t estimate = static_cast<uint64_t>(reciprocal) * hi +
+                            ((static_cast<uint64_t>(hi) << 32) | lo);
+  uint32_t quotient = static_cast<uint32_t>(estimate >> 32) + 1;
+  const uint32_t estimate_low = static_cast<uint32_t>(estimate);
+  uint32_t remainder = lo - quotient * d_normalized;
+  if (remainder > estimate_low) {
+    --quotient;
+    remainder += d_normalized;
+  }
+  if (remainder >= d_normalized) {
+    ++quotient;
+    remainder -= d_normalized;
+  }
+  return {quotient, remainder};
+}
+
 bool sum_is_safe(uint32_t x, uint32_t y) {
   return y <= std::numeric_limits<uint32_t>::max() - x;
 }
@@ -349,3 +411,183 @@ std::pair<uint32_t, uint32_t> multiply_with_carry(const uint32_t x,
 
   return {product, result_carry};
 }
+
+std::vector<uint32_t> residues(const Int& a,
+                               const std::vector<uint32_t>& moduli) {
+  std::vector<uint32_t> result(moduli.size());
+  size_t i = 0;
+  while (i < moduli.size()) {
+    // Reduce a once by the product of as many moduli as fit in one digit,
+    // then finish each modulus with native arithmetic.
+    assert(moduli[i] != 0);
+    uint64_t group = moduli[i];
+    size_t j = i + 1;
+    while (j < moduli.size() &&
+           group * moduli[j] <= std::numeric_limits<uint32_t>::max()) {
+      assert(moduli[j] != 0);
+      group *= moduli[j];
+      ++j;
+    }
+    const uint32_t r = a.mod_ui(DigitDivisor(static_cast<uint32_t>(group)));
+    for (; i < j; ++i) {
+      result[i] = r % moduli[i];
+    }
+  }
+  return result;
+}
+
+namespace {
+// Returns 10^k, caching every power computed during one conversion.
+const std::vector<uint32_t>& power_of_ten(
+    size_t k, std::map<size_t, std::vector<uint32_t>>* cache) {
+  auto it = cache->find(k);
+  if (it != cache->end()) {
+    return it->second;
+  }
+  std::vector<uint32_t> power;
+  if (k <= 9) {
+    uint32_t p = 1;
+    for (size_t i = 0; i < k; ++i) {
+      p *= 10;
+    }
+    power.push_back(p);
+  } else {
+    const std::vector<uint32_t> low = power_of_ten(k / 2, cache);
+    if (k % 2 == 0) {
+      power = square_digits(low);
+    } else {
+      power = multiply_digits(low, power_of_ten(k - k / 2, cache));
+    }
+  }
+  return (*cache)[k] = std::move(power);
+}
+
+// Converts nine decimal characters at a time with a running multiply-add.
+std::vector<uint32_t> decimal_to_digits_chunked(const char* begin,
+                                                const char* end) {
+  std::vector<uint32_t> result;
+  const char* it = begin;
+  // Make the first chunk the short one so that the rest are all nine long.
+  size_t chunk_length = (end - begin) % 9 == 0 ? 9 : (end - begin) % 9;
+  while (it != end) {
+    uint32_t chunk = 0;
+    uint32_t scale = 1;
+    for (size_t i = 0; i < chunk_length; ++i, ++it) {
+      chunk = chunk * 10 + static_cast<uint32_t>(*it - '0');
+      scale *= 10;
+    }
+    uint32_t carry = chunk;
+    for (uint32_t& digit : result) {
+      std::tie(digit, carry) = multiply_with_carry(digit, scale, carry);
+    }
+    if (carry != 0) {
+      result.push_back(carry);
+    }
+    chunk_length = 9;
+  }
+  return result;
+}
+
+std::vector<uint32_t> decimal_to_digits_recursive(
+    const char* begin, const char* end, size_t threshold,
+    std::map<size_t, std::vector<uint32_t>>* powers) {
+  const size_t length = end - begin;
+  if (length <= threshold || length <= 9) {
+    return decimal_to_digits_chunked(begin, end);
+  }
+  // The value is high * 10^low_length + low.
+  const size_t low_length = length / 2;
+  const std::vector<uint32_t> high = decimal_to_digits_recursive(
+      begin, end - low_length, threshold, powers);
+  const std::vector<uint32_t> low =
+      decimal_to_digits_recursive(end - low_length, end, threshold, powers);
+  std::vector<uint32_t> result =
+      multiply_digits(high, power_of_ten(low_length, powers));
+  if (!low.empty()) {
+    mpn::add(result.data(), result.data(), result.size(), low.data(),
+             low.size());
+  }
+  return result;
+}
+}  // namespace
+
+std::vector<uint32_t> decimal_to_digits(const std::string& decimal,
+                                        size_t threshold) {
+  std::map<size_t, std::vector<uint32_t>> powers;
+  const char* begin = decimal.data();
+  return decimal_to_digits_recursive(begin, begin + decimal.size(), threshold,
+                                     &powers);
+}
+
+Modulus::Modulus(const Int& m)
+    : m(m), m_form(Form::kGeneral), p(0), c(0) {
+  assert(m > 1);
+  const std::vector<uint32_t>& m_digits = m.get_digits();
+  const size_t bits = mpn::bit_length(m_digits.data(), m_digits.size());
+  std::vector<uint32_t> power(bits / 32 + 1, 0);
+  power.back() = 1U << (bits % 32);
+  const Int offset = Int(power) - m;
+  if (offset.get_digits().size() != 1) {
+    return;
+  }
+  // A large offset relative to 2^bits would make folding converge slowly,
+  // so pseudo-Mersenne moduli need at least two digits.
+  const uint32_t small_offset = offset.get_digits()[0];
+  if (small_offset == 1 || bits >= 64) {
+    m_form = small_offset == 1 ? Form::kMersenne : Form::kPseudoMersenne;
+    p = bits;
+    c = small_offset;
+  }
+}
+
+void Modulus::reduce_digits(uint32_t* t, size_t tn, uint32_t* scratch) const {
+  assert(m_form != Form::kGeneral);
+  const size_t low_digits = p / 32;
+  const int low_bits = p % 32;
+  // Rewrite high * 2^p + low as high * c + low until high is zero. Each step
+  // shrinks the value, so it still fits in tn digits.
+  tn = mpn::normalized_size(t, tn);
+  while (tn > low_digits) {
+    size_t high_n = tn - low_digits;
+    mpn::rshift(scratch, t + low_digits, high_n, low_bits);
+    high_n = mpn::normalized_size(scratch, high_n);
+    if (high_n == 0) {
+      break;
+    }
+    if (low_bits != 0) {
+      t[low_digits] &= (1U << low_bits) - 1;
+      std::fill(t + low_digits + 1, t + tn, 0);
+    } else {
+      std::fill(t + low_digits, t + tn, 0);
+    }
+    const uint32_t carry = mpn::addmul_1(t, scratch, high_n, c);
+    if (carry != 0) {
+      assert(high_n < tn);
+      mpn::add(t + high_n, t + high_n, tn - high_n, &carry, 1);
+    }
+    tn = mpn::normalized_size(t, tn);
+  }
+  // Now t < 2^p < 2m.
+  const std::vector<uint32_t>& m_digits = m.get_digits();
+  const size_t n = m_digits.size();
+  if (tn == n && mpn::cmp(t, m_digits.data(), n) >= 0) {
+    mpn::sub_n(t, t, m_digits.data(), n);
+  }
+}
+
+Int Int::mod(const Modulus& rhs) const {
+  if (rhs.form() == Modulus::Form::kGeneral) {
+    return mod(rhs.value());
+  }
+  std::vector<uint32_t> folded = digits.get();
+  std::vector<uint32_t> scratch(folded.size());
+  rhs.reduce_digits(folded.data(), folded.size(), scratch.data());
+  const Int result(std::move(folded));
+  // Like mod(const Int&), the result takes the sign of *this.
+  return is_negative ? -result : result;
+}
+
+Int& Int::reduce_mod(const Modulus& rhs) {
+  *this = mod(rhs);
+  return *this;
+}
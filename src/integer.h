@@ -5,12 +5,49 @@
 #include <cstdint>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "shared_digits.h"
+
+// A single digit divisor together with a precomputed reciprocal, following
+// Moller and Granlund, "Improved division by invariant integers". Dividing by
+// it replaces each hardware division with two multiplications.
+class DigitDivisor {
+ public:
+  // Throws std::domain_error if d is zero.
+  explicit DigitDivisor(uint32_t d);
+  uint32_t divisor() const { return d; }
+  // Divides the normalized two digit number hi * 2^32 + lo by the normalized
+  // divisor. Requires hi < normalized_divisor(). Returns {quotient, remainder}.
+  std::pair<uint32_t, uint32_t> divide_normalized(uint32_t hi,
+                                                  uint32_t lo) const;
+  uint32_t normalized_divisor() const { return d_normalized; }
+  int shift() const { return normalizing_shift; }
+
+ private:
+  uint32_t d;
+  // d shifted left so that its most significant bit is set.
+  uint32_t d_normalized;
+  int normalizing_shift;
+  // floor((2^64 - 1) / d_normalized) - 2^32.
+  uint32_t reciprocal;
+};
+
+class Modulus;
+
 class Int {
  public:
   Int(int32_t a);
   Int(std::string a);
+  // Constructs the integer whose base 2^32 digits are given least significant
+  // first. Leading zeros are allowed.
+  explicit Int(std::vector<uint32_t> a, bool negative = false);
+  Int(const Int& other) = default;
+  Int& operator=(const Int& other) = default;
+  // Moving is O(1) and leaves other equal to zero.
+  Int(Int&& other) noexcept;
+  Int& operator=(Int&& other) noexcept;
   friend bool operator<(const Int& lhs, const Int& rhs);
   friend bool operator==(const Int& lhs, const Int& rhs);
   friend bool less_in_magnitude(const Int& lhs, const Int& rhs);
@@ -20,30 +57,65 @@ class Int {
   Int& operator/=(const Int& rhs);
   Int operator-() const;
   int sign() const { return is_negative ? -1 : 1; }
-  std::vector<uint32_t> get_digits() const { return digits; }
+  // The returned reference is invalidated by any modification of *this.
+  const std::vector<uint32_t>& get_digits() const { return digits.get(); }
   std::string debug_string() const;
   void shift_by(int i);
   Int mod(const Int& rhs) const;
   Int& reduce_mod(const Int& rhs);
+  // Like the overloads above, using shifts and adds instead of division when
+  // the modulus has a special form.
+  Int mod(const Modulus& rhs) const;
+  Int& reduce_mod(const Modulus& rhs);
+  // Divides *this by d in place, rounding towards zero, and returns the
+  // remainder of |*this| divided by d. Throws std::domain_error if d is zero,
+  // as does dividing by a zero Int.
+  uint32_t divmod_ui(uint32_t d);
+  uint32_t divmod_ui(const DigitDivisor& d);
+  uint64_t divmod_ui64(uint64_t d);
+  // Returns the remainder of |*this| divided by d.
+  uint32_t mod_ui(const DigitDivisor& d) const;
   std::string print() const;
  private:
   // True if integer is strictly less than 0.
   bool is_negative;
 
   // Integer is stored in base 2^32 where each digit is an element of the vector
-  // v. v[0] is the least significant digit of the integer.
-  std::vector<uint32_t> digits;
-
-  // Implements the borrowing method used in the subtraction algorithm you learn
-  // in primary school. The input is the index of the digit to borrow from.
-  void borrow_from_neighbour(int neighbour);
+  // v. v[0] is the least significant digit of the integer. Copies of an Int
+  // share their digits until one of them is modified.
+  SharedDigits digits;
 
   void add_ignoring_sign(const Int& rhs);
   void subtract_ignoring_sign(const Int& rhs);
   void remove_leading_zeros();
-  Int multiply_ignoring_sign(Int x, uint32_t y);
-  void divide_ignoring_sign(const Int& rhs);
-  void divide_by_2();
+  bool is_zero() const { return digits.size() == 1 && digits[0] == 0; }
+  // Replaces *this by |*this| / |rhs| and returns |*this| mod |rhs|.
+  Int divide_ignoring_sign(const Int& rhs);
+};
+
+// A modulus m > 1 classified by form. Reduction modulo a Mersenne number
+// 2^p - 1 or a pseudo-Mersenne number 2^p - c, with c a single digit and
+// p >= 64, folds the bits above p back onto the low bits instead of dividing.
+class Modulus {
+ public:
+  enum class Form { kMersenne, kPseudoMersenne, kGeneral };
+
+  explicit Modulus(const Int& m);
+  const Int& value() const { return m; }
+  Form form() const { return m_form; }
+  // For the special forms m = 2^exponent() - offset().
+  size_t exponent() const { return p; }
+  uint32_t offset() const { return c; }
+  // For the special forms only: replaces the tn digit number t by t mod m in
+  // place, with zeros above the digits of m. scratch must hold tn digits.
+  // Nothing is allocated.
+  void reduce_digits(uint32_t* t, size_t tn, uint32_t* scratch) const;
+
+ private:
+  Int m;
+  Form m_form;
+  size_t p;
+  uint32_t c;
 };
 
 bool sum_is_safe(uint32_t x, uint32_t y);
@@ -54,22 +126,38 @@ std::pair<uint32_t, uint32_t> add_with_carry(uint32_t x, uint32_t y,
 std::pair<uint32_t, uint32_t> multiply_with_carry(uint32_t x, uint32_t y,
                                                   uint32_t carry);
 
-bool operator!=(const Int& lhs, const Int& rhs) {
+// Converts a string of decimal characters, splitting it in half recursively
+// while it is longer than threshold characters.
+std::vector<uint32_t> decimal_to_digits(const std::string& decimal,
+                                        size_t threshold);
+
+// Returns |a| mod m for every m in moduli. Moduli are grouped so that a is
+// scanned once per group of moduli whose product fits in a digit.
+std::vector<uint32_t> residues(const Int& a,
+                               const std::vector<uint32_t>& moduli);
+
+inline bool operator!=(const Int& lhs, const Int& rhs) {
   return !operator==(lhs, rhs);
 }
 
-bool operator>(const Int& lhs, const Int& rhs) { return operator<(rhs, lhs); }
+inline bool operator>(const Int& lhs, const Int& rhs) {
+  return operator<(rhs, lhs);
+}
 
-bool operator<=(const Int& lhs, const Int& rhs) { return !operator>(lhs, rhs); }
+inline bool operator<=(const Int& lhs, const Int& rhs) {
+  return !operator>(lhs, rhs);
+}
 
-bool operator>=(const Int& lhs, const Int& rhs) { return !operator<(lhs, rhs); }
+inline bool operator>=(const Int& lhs, const Int& rhs) {
+  return !operator<(lhs, rhs);
+}
 
-Int operator+(Int lhs, const Int& rhs) { return lhs += rhs; }
-Int operator-(Int lhs, const Int& rhs) { return lhs -= rhs; }
-Int operator*(Int lhs, const Int& rhs) { return lhs *= rhs; }
-Int operator/(Int lhs, const Int& rhs) { return lhs /= rhs; }
+inline Int operator+(Int lhs, const Int& rhs) { return lhs += rhs; }
+inline Int operator-(Int lhs, const Int& rhs) { return lhs -= rhs; }
+inline Int operator*(Int lhs, const Int& rhs) { return lhs *= rhs; }
+inline Int operator/(Int lhs, const Int& rhs) { return lhs /= rhs; }
 
-void PrintTo(const Int& a, std::ostream* os) {
+inline void PrintTo(const Int& a, std::ostream* os) {
   *os << a.debug_string();  // whatever needed to print bar to os
 }
 
@@ -2,7 +2,11 @@
 
 #include <cstdint>
 #include <limits>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #pragma clang diagnostic push
@@ -330,6 +334,7 @@ TEST(IntTest, Multiply) {
       "16338667371973139355530553882773662438785150"};
 
   EXPECT_EQ(a * b, g);
+  EXPECT_EQ(a * 0, 0);
   EXPECT_EQ(-a * b, -g);
   EXPECT_EQ(a * -b, -g);
   EXPECT_EQ(-a * -b, g);
@@ -353,6 +358,7 @@ TEST(IntTest, Divide) {
   EXPECT_EQ(-two / -two, 1);
   EXPECT_EQ(twelve / -three, -4);
   EXPECT_EQ(-eleven / -three, 3);
+  EXPECT_EQ((negative_one / two).sign(), 1);
 
   const Int d{"4294967295"};
   const Int e{"4294967296"};
@@ -459,3 +465,266 @@ TEST(IntTest, Print) {
   const Int n{"-79228162514264337593543950336"};
   EXPECT_TRUE(n.print() == "-79228162514264337593543950336");
 }
+
+TEST(IntTest, DivmodUi) {
+  Int a{
+      "107150860718626732094842504906000181056140481170553360744375038837035"};
+  const Int q{
+      "107150860718626732094842504906000181056140481170553360744375038"};
+  EXPECT_EQ(a.divmod_ui(1000000), 837035U);
+  EXPECT_EQ(a, q);
+  Int b{-7};
+  EXPECT_EQ(b.divmod_ui(2), 1U);
+  EXPECT_EQ(b, -3);
+  Int c{-7};
+  EXPECT_EQ(c.divmod_ui(8), 7U);
+  EXPECT_EQ(c, 0);
+  EXPECT_EQ(c.sign(), 1);
+  Int d{"18446744069414584320"};
+  EXPECT_EQ(d.divmod_ui(max_uint32_t), 0U);
+  EXPECT_EQ(d, Int{"4294967296"});
+
+  Int e{"79228162514264337593543950336"};
+  EXPECT_EQ(e.divmod_ui64(18446744073709551557ULL), 59ULL << 32);
+  EXPECT_EQ(e, Int{"4294967296"});
+  Int f{"79228162514264337593543950335"};
+  EXPECT_EQ(f.divmod_ui64(10), 5ULL);
+  EXPECT_EQ(f, Int{"7922816251426433759354395033"});
+}
+
+TEST(IntTest, DigitDivisor) {
+  const uint32_t divisors[] = {1, 2, 3, 7, 10, 1000000000, 0x80000000U,
+                               max_uint32_t};
+  const uint64_t dividends[] = {0, 1, 6, 0xFFFFFFFFULL, 0x100000000ULL,
+                                12345678901234567890ULL,
+                                0xFFFFFFFFFFFFFFFFULL};
+  for (const uint32_t d : divisors) {
+    const DigitDivisor divisor(d);
+    for (const uint64_t n : dividends) {
+      const Int a(std::vector<uint32_t>{static_cast<uint32_t>(n),
+                                        static_cast<uint32_t>(n >> 32)});
+      const uint64_t expected_quotient = n / d;
+      Int quotient = a;
+      EXPECT_EQ(quotient.divmod_ui(divisor), n % d);
+      EXPECT_EQ(quotient,
+                Int(std::vector<uint32_t>{
+                    static_cast<uint32_t>(expected_quotient),
+                    static_cast<uint32_t>(expected_quotient >> 32)}));
+      EXPECT_EQ(a.mod_ui(divisor), n % d);
+    }
+  }
+
+  const Int a{
+      "-26959946667150639794667015087019630673637144422540572481103610249215"};
+  for (const uint32_t d : divisors) {
+    Int quotient = a;
+    const uint32_t remainder = quotient.divmod_ui(DigitDivisor(d));
+    EXPECT_EQ(quotient * Int(std::vector<uint32_t>{d}) -
+                  Int(std::vector<uint32_t>{remainder}),
+              a);
+    EXPECT_LT(remainder, d);
+  }
+  const DigitDivisor seven(7);
+  EXPECT_EQ(seven.divisor(), 7U);
+  EXPECT_EQ(seven.shift(), 29);
+  EXPECT_EQ(seven.normalized_divisor(), 0xE0000000U);
+
+  EXPECT_THROW(DigitDivisor(0), std::domain_error);
+  Int b{12};
+  EXPECT_THROW(b.divmod_ui(0), std::domain_error);
+  EXPECT_THROW(b.divmod_ui64(0), std::domain_error);
+  EXPECT_THROW(b / 0, std::domain_error);
+  EXPECT_THROW(Int{"18446744073709551616"} / 0, std::domain_error);
+}
+
+TEST(IntTest, Residues) {
+  const Int a{
+      "26959946667150639794667015087019630673637144422540572481103610249215"};
+  const std::vector<uint32_t> moduli{2,  3,  5,   7,     11,         13,
+                                     17, 19, 23,  65537, 4294967291U, 1,
+                                     10, 97, 101, 1000000007};
+  const std::vector<uint32_t> result = residues(a, moduli);
+  ASSERT_EQ(result.size(), moduli.size());
+  for (size_t i = 0; i < moduli.size(); ++i) {
+    EXPECT_EQ(result[i], a.mod_ui(DigitDivisor(moduli[i])));
+  }
+  EXPECT_EQ(result[0], 1U);
+  EXPECT_EQ(result[12], 5U);
+  EXPECT_EQ(residues(-a, moduli), result);
+  EXPECT_TRUE(residues(a, {}).empty());
+}
+
+TEST(IntTest, CopyOnWrite) {
+  const Int a{
+      "26959946667150639794667015087019630673637144422540572481103610249215"};
+  Int b = a;
+  EXPECT_EQ(a.get_digits().data(), b.get_digits().data());
+
+  b += 1;
+  EXPECT_NE(a.get_digits().data(), b.get_digits().data());
+  EXPECT_EQ(a, Int{"269599466671506397946670150870196306736371444225405724811"
+                   "03610249215"});
+  EXPECT_EQ(b, a + 1);
+
+  // Negation and comparison leave the digits shared.
+  const Int c = -a;
+  EXPECT_EQ(a.get_digits().data(), c.get_digits().data());
+  EXPECT_TRUE(c < a);
+
+  // Copies of the same value can be modified concurrently.
+  std::vector<Int> results(8, 0);
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < 8; ++t) {
+    threads.emplace_back([&a, &results, t] {
+      Int x = a;
+      for (int32_t i = 0; i < 100; ++i) {
+        Int y = x;
+        y += t;
+        x = y;
+      }
+      results[t] = x;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int32_t t = 0; t < 8; ++t) {
+    EXPECT_EQ(results[t], a + 100 * t);
+  }
+}
+
+TEST(IntTest, MovedFrom) {
+  Int a{5};
+  const Int b = std::move(a);
+  EXPECT_EQ(b, 5);
+  // A moved-from Int is zero, and can be read, copied and assigned to.
+  EXPECT_EQ(a, 0);
+  const Int copy = a;
+  EXPECT_EQ(copy.print(), "0");
+  EXPECT_EQ(a.sign(), 1);
+  a += 3;
+  EXPECT_EQ(a, 3);
+  a = 7;
+  EXPECT_EQ(a, 7);
+  EXPECT_EQ(a + b, 12);
+
+  // Moving takes the digits without copying or sharing them.
+  Int c{"-123456789012345678901234567890"};
+  const uint32_t* const c_data = c.get_digits().data();
+  Int d{0};
+  d = std::move(c);
+  EXPECT_EQ(d.get_digits().data(), c_data);
+  EXPECT_EQ(d, Int("-123456789012345678901234567890"));
+  EXPECT_EQ(c, 0);
+  EXPECT_EQ(c.sign(), 1);
+  Int e = std::move(d);
+  EXPECT_EQ(e.get_digits().data(), c_data);
+  e += 1;
+  EXPECT_EQ(e.get_digits().data(), c_data);
+  EXPECT_EQ(e, Int("-123456789012345678901234567889"));
+  c += 1;
+  c = e * 2;
+  EXPECT_EQ(c, Int("-246913578024691357802469135778"));
+  EXPECT_EQ(d, 0);
+
+  Int& f = e;
+  e = std::move(f);
+  EXPECT_EQ(e, Int("-123456789012345678901234567889"));
+}
+
+TEST(IntTest, Division) {
+  std::mt19937 gen(42);
+  for (const size_t m : {1, 2, 5, 30}) {
+    for (const size_t n : {1, 2, 3, 30}) {
+      std::vector<uint32_t> a_digits(m);
+      std::vector<uint32_t> b_digits(n);
+      for (uint32_t& digit : a_digits) {
+        digit = gen();
+      }
+      for (uint32_t& digit : b_digits) {
+        digit = gen() >> (gen() % 32);
+      }
+      b_digits.back() |= 1;
+      const Int a(a_digits);
+      const Int b(b_digits);
+      const Int q = a / b;
+      const Int r = a.mod(b);
+      EXPECT_EQ(q * b + r, a);
+      EXPECT_TRUE(r >= 0 && r < b);
+      EXPECT_EQ(-a / b, -q);
+      EXPECT_EQ((-a).mod(b), -r);
+    }
+  }
+  const Int a{"340282366920938463463374607431768211455"};
+  EXPECT_EQ(a / a, 1);
+  EXPECT_EQ(a.mod(a), 0);
+  EXPECT_EQ(a / (a + 1), 0);
+  EXPECT_EQ(a.mod(a + 1), a);
+}
+
+TEST(IntTest, DecimalConversion) {
+  std::mt19937 gen(7);
+  std::string decimal = "9";
+  for (int i = 0; i < 3000; ++i) {
+    decimal += static_cast<char>('0' + gen() % 10);
+  }
+  const Int expected{decimal_to_digits(decimal, 1000000)};
+  EXPECT_EQ(Int(decimal_to_digits(decimal, 10)), expected);
+  EXPECT_EQ(Int(decimal_to_digits(decimal, 500)), expected);
+  EXPECT_EQ(Int(decimal).print(), decimal);
+  EXPECT_EQ(Int("-" + decimal).print(), "-" + decimal);
+  EXPECT_EQ(Int("000123").print(), "123");
+  EXPECT_EQ(Int("-000").sign(), 1);
+  EXPECT_THROW(Int("12a3"), std::invalid_argument);
+  EXPECT_THROW(Int(""), std::invalid_argument);
+
+  const Int a{decimal};
+  EXPECT_EQ(a * a, a * Int(decimal));
+  EXPECT_EQ((a * a).print(), (a * Int(decimal)).print());
+}
+
+TEST(IntTest, SpecialFormModulus) {
+  const Int mersenne{"170141183460469231731687303715884105727"};
+  const Modulus m127(mersenne);
+  EXPECT_EQ(m127.form(), Modulus::Form::kMersenne);
+  EXPECT_EQ(m127.exponent(), 127);
+  EXPECT_EQ(m127.offset(), 1);
+  EXPECT_EQ(Modulus(7).form(), Modulus::Form::kMersenne);
+
+  const Int p25519{
+      "57896044618658097711785492504343953926634992332820282019728792003956"
+      "564819949"};
+  const Modulus m255(p25519);
+  EXPECT_EQ(m255.form(), Modulus::Form::kPseudoMersenne);
+  EXPECT_EQ(m255.exponent(), 255);
+  EXPECT_EQ(m255.offset(), 19);
+  EXPECT_EQ(Modulus(Int("18446744073709551557")).form(),
+            Modulus::Form::kPseudoMersenne);
+
+  // Small offsets of short moduli and offsets of two digits are not special.
+  EXPECT_EQ(Modulus(5).form(), Modulus::Form::kGeneral);
+  EXPECT_EQ(Modulus(Int("4294967291")).form(), Modulus::Form::kGeneral);
+  EXPECT_EQ(Modulus(Int("1000000000000000000000000000057")).form(),
+            Modulus::Form::kGeneral);
+  EXPECT_EQ(Modulus(Int("340282366920938463444927863358058659841")).form(),
+            Modulus::Form::kGeneral);
+
+  std::mt19937 gen(11);
+  for (const Int& m : {mersenne, p25519, Int("18446744073709551557"), Int(7),
+                       Int("1000000000000000000000000000057")}) {
+    const Modulus modulus(m);
+    std::vector<Int> values{0, 1, m - 1, m, m + 1, m * m - 1, -(m * 3 + 2)};
+    for (int i = 0; i < 10; ++i) {
+      std::vector<uint32_t> digits(1 + gen() % 20);
+      for (uint32_t& digit : digits) {
+        digit = gen();
+      }
+      values.push_back(Int(digits, i % 2 == 1));
+    }
+    for (const Int& x : values) {
+      EXPECT_EQ(x.mod(modulus), x.mod(m));
+      Int y = x;
+      EXPECT_EQ(y.reduce_mod(modulus), x.mod(m));
+    }
+  }
+}
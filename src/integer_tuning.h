@@ -0,0 +1,23 @@
+// Algorithm crossover points used by the integer library.
+//
+// These are defaults that suit typical x86-64 machines. To tune them for the
+// host, run
+//   bazel run -c opt //src:tune -- $PWD/src/integer_tuning.h
+// which measures every crossover and overwrites this file.
+
+#ifndef NUMBER_SRC_INTEGER_TUNING_H
+#define NUMBER_SRC_INTEGER_TUNING_H
+
+#include <cstddef>
+
+// Operands with at least this many digits are multiplied with Karatsuba.
+constexpr size_t kMultiplyKaratsubaThreshold = 40;
+
+// Operands with at least this many digits are squared with Karatsuba.
+constexpr size_t kSquareKaratsubaThreshold = 80;
+
+// Decimal strings longer than this many characters are converted by splitting
+// them in half recursively.
+constexpr size_t kFromDecimalDivideAndConquerThreshold = 20000;
+
+#endif  // NUMBER_SRC_INTEGER_TUNING_H
@@ -0,0 +1,505 @@
+#include "modular.h"
+
+#include "mpn.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+// Above this many terms multi_pow_mod switches from Straus to Pippenger.
+const size_t kPippengerThreshold = 32;
+
+// Window width used by the Straus tables.
+const int kStrausWindow = 4;
+
+// Returns a mod m in [0, m).
+Int reduce(const Int& a, const Int& m) {
+  Int r = a.mod(m);
+  if (r < 0) {
+    r += m;
+  }
+  return r;
+}
+
+Int reduce(const Int& a, const Modulus& m) {
+  Int r = a.mod(m);
+  if (r < 0) {
+    r += m.value();
+  }
+  return r;
+}
+
+// Montgomery multiplication needs an odd modulus. Callers check for the
+// special forms first, which fold faster.
+bool use_montgomery(const Modulus& m) {
+  return (m.value().get_digits()[0] & 1U) != 0;
+}
+
+// Returns the width bits of digits starting at bit position lowest.
+uint32_t window_at(const std::vector<uint32_t>& digits, size_t lowest,
+                   int width) {
+  uint32_t result = 0;
+  for (int i = width - 1; i >= 0; --i) {
+    const size_t bit = lowest + i;
+    const size_t digit = bit / 32;
+    result <<= 1;
+    if (digit < digits.size()) {
+      result |= (digits[digit] >> (bit % 32)) & 1U;
+    }
+  }
+  return result;
+}
+
+// Multiplication modulo an even general m, reducing each product with
+// Int::mod.
+class PlainArithmetic {
+ public:
+  using Element = Int;
+
+  explicit PlainArithmetic(const Modulus& m) : modulus(m), one_element(1) {}
+
+  const Element& one() const { return one_element; }
+  Element from_int(const Int& a) const { return a; }
+  Int to_int(const Element& a) const { return a; }
+  Element multiply(const Element& a, const Element& b) const {
+    return (a * b).mod(modulus);
+  }
+  void multiply_into(const Element& a, const Element& b, Element* out) const {
+    *out = multiply(a, b);
+  }
+
+ private:
+  Modulus modulus;
+  Int one_element;
+};
+
+// Multiplication modulo a special-form m. Elements are residues of exactly
+// as many digits as m, and products are folded in place, so nothing is
+// allocated per multiplication.
+class SpecialFormArithmetic {
+ public:
+  using Element = std::vector<uint32_t>;
+
+  explicit SpecialFormArithmetic(const Modulus& m)
+      : modulus(m),
+        n(m.value().get_digits().size()),
+        one_element(n, 0),
+        product(2 * n),
+        fold_scratch(2 * n),
+        mul_scratch(mpn::mul_scratch_size(n, n)) {
+    assert(m.form() != Modulus::Form::kGeneral);
+    one_element[0] = 1;
+  }
+
+  const Element& one() const { return one_element; }
+  Element from_int(const Int& a) const {
+    Element digits = a.get_digits();
+    digits.resize(n, 0);
+    return digits;
+  }
+  Int to_int(const Element& a) const { return Int(a); }
+  Element multiply(const Element& a, const Element& b) const {
+    Element out;
+    multiply_into(a, b, &out);
+    return out;
+  }
+  void multiply_into(const Element& a, const Element& b, Element* out) const {
+    if (&a == &b) {
+      mpn::sqr(product.data(), a.data(), n, mul_scratch.data());
+    } else {
+      mpn::mul(product.data(), a.data(), n, b.data(), n, mul_scratch.data());
+    }
+    modulus.reduce_digits(product.data(), 2 * n, fold_scratch.data());
+    out->assign(product.begin(), product.begin() + n);
+  }
+
+ private:
+  Modulus modulus;
+  size_t n;
+  Element one_element;
+  mutable std::vector<uint32_t> product;
+  mutable std::vector<uint32_t> fold_scratch;
+  mutable std::vector<uint32_t> mul_scratch;
+};
+
+template <typename Arithmetic>
+std::vector<Int> batch_inverse_with(const Arithmetic& arith,
+                                    const std::vector<Int>& a,
+                                    const Modulus& m) {
+  using Element = typename Arithmetic::Element;
+  std::vector<Int> result(a.size(), 0);
+  if (a.empty()) {
+    return result;
+  }
+  // prefix[i] is the product of the first i + 1 elements.
+  std::vector<Element> elements;
+  std::vector<Element> prefix;
+  elements.reserve(a.size());
+  prefix.reserve(a.size());
+  for (const Int& x : a) {
+    elements.push_back(arith.from_int(reduce(x, m)));
+    prefix.push_back(prefix.empty() ? elements.back()
+                                    : arith.multiply(prefix.back(),
+                                                     elements.back()));
+  }
+  // running is the inverse of the product of the first i + 1 elements.
+  Element running =
+      arith.from_int(inverse_mod(arith.to_int(prefix.back()), m.value()));
+  for (size_t i = a.size() - 1; i > 0; --i) {
+    result[i] = arith.to_int(arith.multiply(running, prefix[i - 1]));
+    running = arith.multiply(running, elements[i]);
+  }
+  result[0] = arith.to_int(running);
+  return result;
+}
+
+template <typename Arithmetic>
+Int straus(const Arithmetic& arith, const std::vector<Int>& bases,
+           const std::vector<std::vector<uint32_t>>& exponents,
+           size_t max_bits, const Modulus& m) {
+  using Element = typename Arithmetic::Element;
+  const size_t table_size = size_t{1} << kStrausWindow;
+  // tables[i][k] is bases[i]^k.
+  std::vector<std::vector<Element>> tables;
+  tables.reserve(bases.size());
+  for (const Int& base : bases) {
+    std::vector<Element> table;
+    table.reserve(table_size);
+    table.push_back(arith.one());
+    table.push_back(arith.from_int(reduce(base, m)));
+    for (size_t k = 2; k < table_size; ++k) {
+      table.push_back(arith.multiply(table[k - 1], table[1]));
+    }
+    tables.push_back(std::move(table));
+  }
+
+  Element acc = arith.one();
+  Element tmp = acc;
+  bool acc_is_one = true;
+  const size_t windows = (max_bits + kStrausWindow - 1) / kStrausWindow;
+  for (size_t w = windows; w > 0; --w) {
+    if (!acc_is_one) {
+      for (int s = 0; s < kStrausWindow; ++s) {
+        arith.multiply_into(acc, acc, &tmp);
+        std::swap(acc, tmp);
+      }
+    }
+    for (size_t i = 0; i < bases.size(); ++i) {
+      const uint32_t k =
+          window_at(exponents[i], (w - 1) * kStrausWindow, kStrausWindow);
+      if (k != 0) {
+        arith.multiply_into(acc, tables[i][k], &tmp);
+        std::swap(acc, tmp);
+        acc_is_one = false;
+      }
+    }
+  }
+  return arith.to_int(acc);
+}
+
+template <typename Arithmetic>
+Int pippenger(const Arithmetic& arith, const std::vector<Int>& bases,
+              const std::vector<std::vector<uint32_t>>& exponents,
+              size_t max_bits, const Modulus& m) {
+  using Element = typename Arithmetic::Element;
+  // Each window costs one multiplication per term plus two per bucket, so
+  // the window grows with the logarithm of the number of terms.
+  int width = 1;
+  while ((size_t{1} << (width + 2)) < bases.size() && width < 16) {
+    ++width;
+  }
+  std::vector<Element> reduced;
+  reduced.reserve(bases.size());
+  for (const Int& base : bases) {
+    reduced.push_back(arith.from_int(reduce(base, m)));
+  }
+
+  const size_t num_buckets = (size_t{1} << width) - 1;
+  std::vector<Element> buckets(num_buckets, arith.one());
+  std::vector<bool> bucket_used(num_buckets);
+  Element acc = arith.one();
+  Element tmp = acc;
+  const size_t windows = (max_bits + width - 1) / width;
+  for (size_t w = windows; w > 0; --w) {
+    for (int s = 0; s < width; ++s) {
+      arith.multiply_into(acc, acc, &tmp);
+      std::swap(acc, tmp);
+    }
+    std::fill(bucket_used.begin(), bucket_used.end(), false);
+    for (size_t i = 0; i < bases.size(); ++i) {
+      const uint32_t k = window_at(exponents[i], (w - 1) * width, width);
+      if (k == 0) {
+        continue;
+      }
+      if (bucket_used[k - 1]) {
+        arith.multiply_into(buckets[k - 1], reduced[i], &tmp);
+        std::swap(buckets[k - 1], tmp);
+      } else {
+        buckets[k - 1] = reduced[i];
+        bucket_used[k - 1] = true;
+      }
+    }
+    // The product of bucket[k]^k is the product over j of the running
+    // products of the buckets from the top down to j.
+    Element running = arith.one();
+    Element total = arith.one();
+    bool running_is_one = true;
+    for (size_t k = num_buckets; k > 0; --k) {
+      if (bucket_used[k - 1]) {
+        arith.multiply_into(running, buckets[k - 1], &tmp);
+        std::swap(running, tmp);
+        running_is_one = false;
+      }
+      if (!running_is_one) {
+        arith.multiply_into(total, running, &tmp);
+        std::swap(total, tmp);
+      }
+    }
+    arith.multiply_into(acc, total, &tmp);
+    std::swap(acc, tmp);
+  }
+  return arith.to_int(acc);
+}
+
+template <typename Arithmetic>
+Int multi_pow_with(const Arithmetic& arith, const std::vector<Int>& bases,
+                   const std::vector<Int>& exponents, const Modulus& m) {
+  std::vector<std::vector<uint32_t>> exponent_digits;
+  exponent_digits.reserve(exponents.size());
+  size_t max_bits = 0;
+  for (const Int& e : exponents) {
+    assert(e >= 0);
+    const std::vector<uint32_t>& digits = e.get_digits();
+    exponent_digits.push_back(digits);
+    max_bits =
+        std::max(max_bits, mpn::bit_length(digits.data(), digits.size()));
+  }
+  if (bases.size() < kPippengerThreshold) {
+    return straus(arith, bases, exponent_digits, max_bits, m);
+  }
+  return pippenger(arith, bases, exponent_digits, max_bits, m);
+}
+}  // namespace
+
+Montgomery::Montgomery(const Int& m)
+    : modulus(m.get_digits()), n(modulus.size()), scratch(n + 2) {
+  assert(m > 1);
+  assert(modulus[0] & 1U);
+  // Newton iteration doubles the number of correct low bits each step.
+  uint32_t inverse = modulus[0];
+  for (int i = 0; i < 4; ++i) {
+    inverse *= 2 - modulus[0] * inverse;
+  }
+  minus_inverse = -inverse;
+
+  Int r_squared{1};
+  r_squared.shift_by(2 * n);
+  r_squared_mod_m = widen(r_squared.mod(m));
+  Element unit(n, 0);
+  unit[0] = 1;
+  one_element = multiply(unit, r_squared_mod_m);
+}
+
+Montgomery::Element Montgomery::from_int(const Int& a) const {
+  return multiply(widen(a), r_squared_mod_m);
+}
+
+Int Montgomery::to_int(const Element& a) const {
+  Element unit(n, 0);
+  unit[0] = 1;
+  return Int(multiply(a, unit));
+}
+
+Montgomery::Element Montgomery::multiply(const Element& a,
+                                         const Element& b) const {
+  Element result;
+  multiply_into(a, b, &result);
+  return result;
+}
+
+void Montgomery::multiply_into(const Element& a, const Element& b,
+                               Element* out) const {
+  // Coarsely integrated operand scanning: interleave one row of the
+  // schoolbook product with one step of Montgomery reduction.
+  std::vector<uint32_t>& t = scratch;
+  std::fill(t.begin(), t.end(), 0);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < n; ++j) {
+      const uint64_t sum = t[j] + static_cast<uint64_t>(a[j]) * b[i] + carry;
+      t[j] = static_cast<uint32_t>(sum);
+      carry = sum >> 32;
+    }
+    uint64_t sum = t[n] + carry;
+    t[n] = static_cast<uint32_t>(sum);
+    t[n + 1] = static_cast<uint32_t>(sum >> 32);
+
+    const uint32_t q = t[0] * minus_inverse;
+    carry = (t[0] + static_cast<uint64_t>(q) * modulus[0]) >> 32;
+    for (size_t j = 1; j < n; ++j) {
+      sum = t[j] + static_cast<uint64_t>(q) * modulus[j] + carry;
+      t[j - 1] = static_cast<uint32_t>(sum);
+      carry = sum >> 32;
+    }
+    sum = t[n] + carry;
+    t[n - 1] = static_cast<uint32_t>(sum);
+    t[n] = t[n + 1] + static_cast<uint32_t>(sum >> 32);
+  }
+  out->assign(t.begin(), t.begin() + n);
+  if (t[n] != 0 || !less_than_modulus(*out)) {
+    subtract_modulus(out);
+  }
+}
+
+Montgomery::Element Montgomery::add(const Element& a, const Element& b) const {
+  Element result(n);
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t sum = static_cast<uint64_t>(a[i]) + b[i] + carry;
+    result[i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+  if (carry != 0 || !less_than_modulus(result)) {
+    subtract_modulus(&result);
+  }
+  return result;
+}
+
+Montgomery::Element Montgomery::subtract(const Element& a,
+                                         const Element& b) const {
+  Element result(n);
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t diff = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+    result[i] = static_cast<uint32_t>(diff);
+    borrow = (diff >> 32) & 1U;
+  }
+  if (borrow != 0) {
+    // The difference wrapped around 2^(32n); adding m brings it back.
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const uint64_t sum =
+          static_cast<uint64_t>(result[i]) + modulus[i] + carry;
+      result[i] = static_cast<uint32_t>(sum);
+      carry = sum >> 32;
+    }
+  }
+  return result;
+}
+
+Montgomery::Element Montgomery::pow(const Element& base,
+                                    const Int& exponent) const {
+  assert(exponent >= 0);
+  const std::vector<uint32_t>& digits = exponent.get_digits();
+  Element acc = one_element;
+  Element tmp;
+  for (size_t bit = mpn::bit_length(digits.data(), digits.size()); bit > 0;
+       --bit) {
+    multiply_into(acc, acc, &tmp);
+    std::swap(acc, tmp);
+    if ((digits[(bit - 1) / 32] >> ((bit - 1) % 32)) & 1U) {
+      multiply_into(acc, base, &tmp);
+      std::swap(acc, tmp);
+    }
+  }
+  return acc;
+}
+
+Montgomery::Element Montgomery::widen(const Int& a) const {
+  Element digits = a.get_digits();
+  digits.resize(n, 0);
+  return digits;
+}
+
+bool Montgomery::less_than_modulus(const Element& a) const {
+  for (size_t i = n; i > 0; --i) {
+    if (a[i - 1] != modulus[i - 1]) {
+      return a[i - 1] < modulus[i - 1];
+    }
+  }
+  return false;
+}
+
+void Montgomery::subtract_modulus(Element* a) const {
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t diff = static_cast<uint64_t>((*a)[i]) - modulus[i] - borrow;
+    (*a)[i] = static_cast<uint32_t>(diff);
+    borrow = (diff >> 32) & 1U;
+  }
+}
+
+Int inverse_mod(const Int& a, const Int& m) {
+  assert(m > 0);
+  // Extended Euclidean algorithm, tracking only the coefficient of a.
+  Int old_r = reduce(a, m);
+  Int r = m;
+  Int old_s{1};
+  Int s{0};
+  while (r != 0) {
+    const Int q = old_r / r;
+    Int next_r = old_r - q * r;
+    old_r = std::move(r);
+    r = std::move(next_r);
+    Int next_s = old_s - q * s;
+    old_s = std::move(s);
+    s = std::move(next_s);
+  }
+  if (old_r != 1) {
+    throw std::invalid_argument("element is not invertible");
+  }
+  return reduce(old_s, m);
+}
+
+std::vector<Int> batch_inverse_mod(const std::vector<Int>& a, const Int& m) {
+  assert(m > 0);
+  if (m == 1) {
+    return std::vector<Int>(a.size(), 0);
+  }
+  const Modulus modulus(m);
+  if (modulus.form() != Modulus::Form::kGeneral) {
+    return batch_inverse_with(SpecialFormArithmetic(modulus), a, modulus);
+  }
+  if (use_montgomery(modulus)) {
+    return batch_inverse_with(Montgomery(m), a, modulus);
+  }
+  return batch_inverse_with(PlainArithmetic(modulus), a, modulus);
+}
+
+Int mul_mod(const Int& a, const Int& b, const Modulus& m) {
+  return reduce(a * b, m);
+}
+
+Int pow_mod(const Int& base, const Int& exponent, const Int& m) {
+  return multi_pow_mod({base}, {exponent}, m);
+}
+
+Int pow_mod(const Int& base, const Int& exponent, const Modulus& m) {
+  return multi_pow_mod({base}, {exponent}, m);
+}
+
+Int multi_pow_mod(const std::vector<Int>& bases,
+                  const std::vector<Int>& exponents, const Int& m) {
+  assert(m > 0);
+  if (m == 1) {
+    assert(bases.size() == exponents.size());
+    return 0;
+  }
+  return multi_pow_mod(bases, exponents, Modulus(m));
+}
+
+Int multi_pow_mod(const std::vector<Int>& bases,
+                  const std::vector<Int>& exponents, const Modulus& m) {
+  assert(bases.size() == exponents.size());
+  if (m.form() != Modulus::Form::kGeneral) {
+    return multi_pow_with(SpecialFormArithmetic(m), bases, exponents, m);
+  }
+  if (use_montgomery(m)) {
+    return multi_pow_with(Montgomery(m.value()), bases, exponents, m);
+  }
+  return multi_pow_with(PlainArithmetic(m), bases, exponents, m);
+}
@@ -0,0 +1,77 @@
+#ifndef NUMBER_SRC_MODULAR_H
+#define NUMBER_SRC_MODULAR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "integer.h"
+
+// Arithmetic modulo a fixed odd m > 1. Elements are fixed width digit vectors
+// holding x * 2^(32n) mod m, where n is the number of digits of m, so that
+// multiplication needs no division. An instance reuses internal scratch space
+// and must not be shared between threads.
+class Montgomery {
+ public:
+  using Element = std::vector<uint32_t>;
+
+  explicit Montgomery(const Int& m);
+
+  const Element& one() const { return one_element; }
+  // Requires 0 <= a < m.
+  Element from_int(const Int& a) const;
+  Int to_int(const Element& a) const;
+
+  Element multiply(const Element& a, const Element& b) const;
+  void multiply_into(const Element& a, const Element& b, Element* out) const;
+  Element add(const Element& a, const Element& b) const;
+  Element subtract(const Element& a, const Element& b) const;
+  // Requires exponent >= 0.
+  Element pow(const Element& base, const Int& exponent) const;
+
+ private:
+  Element modulus;
+  size_t n;
+  // -m^-1 mod 2^32.
+  uint32_t minus_inverse;
+  Element r_squared_mod_m;
+  Element one_element;
+  mutable std::vector<uint32_t> scratch;
+
+  Element widen(const Int& a) const;
+  bool less_than_modulus(const Element& a) const;
+  void subtract_modulus(Element* a) const;
+};
+
+// All functions below require m > 0 and return values in [0, m). Those that
+// multiply classify m first, so products modulo Mersenne and pseudo-Mersenne
+// numbers are folded in place with shifts and adds (Modulus::reduce_digits)
+// rather than reduced by Montgomery multiplication or division.
+
+// Returns the inverse of a modulo m. Throws std::invalid_argument if a is not
+// invertible modulo m.
+Int inverse_mod(const Int& a, const Int& m);
+
+// Returns the inverses of every element of a modulo m using Montgomery's
+// trick: one inversion and 3(n - 1) modular multiplications. For a general odd
+// m the elements are also converted into and out of Montgomery form, which
+// costs another 2n + 2 Montgomery multiplications. Throws
+// std::invalid_argument if any element is not invertible modulo m.
+std::vector<Int> batch_inverse_mod(const std::vector<Int>& a, const Int& m);
+
+// Returns a * b mod m.
+Int mul_mod(const Int& a, const Int& b, const Modulus& m);
+
+// Returns base^exponent mod m. Requires exponent >= 0.
+Int pow_mod(const Int& base, const Int& exponent, const Int& m);
+Int pow_mod(const Int& base, const Int& exponent, const Modulus& m);
+
+// Returns the product of bases[i]^exponents[i] mod m. The squarings are shared
+// between all terms (Straus), and for many terms the multiplications are
+// gathered into buckets per window (Pippenger). Requires every exponent to be
+// nonnegative and the two vectors to have the same length.
+Int multi_pow_mod(const std::vector<Int>& bases,
+                  const std::vector<Int>& exponents, const Int& m);
+Int multi_pow_mod(const std::vector<Int>& bases,
+                  const std::vector<Int>& exponents, const Modulus& m);
+
+#endif  // NUMBER_SRC_MODULAR_H
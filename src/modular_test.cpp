@@ -0,0 +1,165 @@
+#include "modular.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "integer.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "gtest/gtest.h"
+#pragma clang diagnostic pop
+
+namespace {
+Int naive_pow_mod(const Int& base, uint32_t exponent, const Int& m) {
+  Int result{1};
+  for (uint32_t i = 0; i < exponent; ++i) {
+    result = (result * base).mod(m);
+  }
+  Int r = result.mod(m);
+  return r < 0 ? r + m : r;
+}
+}  // namespace
+
+TEST(ModularTest, InverseMod) {
+  EXPECT_EQ(inverse_mod(3, 7), 5);
+  EXPECT_EQ(inverse_mod(-3, 7), 2);
+  EXPECT_EQ(inverse_mod(10, 7), 5);
+  EXPECT_EQ(inverse_mod(5, 1), 0);
+  EXPECT_THROW(inverse_mod(4, 8), std::invalid_argument);
+  EXPECT_THROW(inverse_mod(0, 7), std::invalid_argument);
+
+  const Int p{
+      "115792089237316195423570985008687907853269984665640564039457584007908834"
+      "671663"};
+  const Int a{
+      "550662630222773436695787188951685343262506034537775941755001873603891167"
+      "29240"};
+  EXPECT_EQ((a * inverse_mod(a, p)).mod(p), 1);
+}
+
+TEST(ModularTest, BatchInverseMod) {
+  const Int p{"340282366920938463463374607431768211297"};
+  std::vector<Int> a;
+  for (int32_t i = 1; i < 40; ++i) {
+    a.push_back(Int(i) * Int("123456789123456789") - 17 * i);
+  }
+  const std::vector<Int> inverses = batch_inverse_mod(a, p);
+  ASSERT_EQ(inverses.size(), a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(inverses[i], inverse_mod(a[i], p));
+  }
+
+  const std::vector<Int> even_inverses = batch_inverse_mod({3, 5, 7, -1}, 16);
+  const std::vector<Int> expected{11, 13, 7, 15};
+  EXPECT_EQ(even_inverses, expected);
+
+  EXPECT_TRUE(batch_inverse_mod({}, p).empty());
+  EXPECT_THROW(batch_inverse_mod({3, 14, 5}, 7), std::invalid_argument);
+}
+
+TEST(ModularTest, PowMod) {
+  EXPECT_EQ(pow_mod(2, 10, 1000), 24);
+  EXPECT_EQ(pow_mod(2, 0, 1000), 1);
+  EXPECT_EQ(pow_mod(0, 0, 7), 1);
+  EXPECT_EQ(pow_mod(5, 3, 1), 0);
+  EXPECT_EQ(pow_mod(-2, 3, 7), 6);
+  EXPECT_EQ(pow_mod(3, 100, 101), 1);
+
+  const Int m{"1000000000000000000000000000057"};
+  const Int b{"123456789012345678901234567890"};
+  EXPECT_EQ(pow_mod(b, 77, m), naive_pow_mod(b, 77, m));
+  EXPECT_EQ(pow_mod(b, 77, m + 1), naive_pow_mod(b, 77, m + 1));
+
+  // Fermat's little theorem for the Mersenne prime 2^127 - 1.
+  const Int p{"170141183460469231731687303715884105727"};
+  EXPECT_EQ(pow_mod(b, p - 1, p), 1);
+  EXPECT_EQ(pow_mod(b, p, p), b);
+}
+
+TEST(ModularTest, MultiPowMod) {
+  const Int m{"1000000000000000000000000000057"};
+  EXPECT_EQ(multi_pow_mod({}, {}, m), 1);
+  for (const size_t n : {1, 3, 40}) {
+    // Forty terms is above the threshold where Pippenger is used.
+    std::vector<Int> bases;
+    std::vector<Int> exponents;
+    Int expected{1};
+    for (size_t i = 0; i < n; ++i) {
+      const int32_t k = static_cast<int32_t>(i);
+      bases.push_back(Int("98765432109876543210") * (k + 1) + k);
+      const uint32_t e = k % 5 == 0 ? 0 : 3 * k + 50;
+      exponents.push_back(static_cast<int32_t>(e));
+      expected = (expected * naive_pow_mod(bases.back(), e, m)).mod(m);
+    }
+    EXPECT_EQ(multi_pow_mod(bases, exponents, m), expected);
+  }
+
+  const Int even{"1267650600228229401496703205376"};
+  std::vector<Int> bases{3, 5, 7};
+  std::vector<Int> exponents{Int("1000000000000"), 12345, 0};
+  EXPECT_EQ(multi_pow_mod(bases, exponents, even),
+            (pow_mod(3, Int("1000000000000"), even) * pow_mod(5, 12345, even))
+                .mod(even));
+}
+
+TEST(ModularTest, Montgomery) {
+  const Int m{"1000000000000000000000000000057"};
+  const Montgomery mont(m);
+  const Int a{"123456789012345678901234567890"};
+  const Int b{"999999999999999999999999999999"};
+  const Montgomery::Element x = mont.from_int(a);
+  const Montgomery::Element y = mont.from_int(b);
+  EXPECT_EQ(mont.to_int(mont.one()), 1);
+  EXPECT_EQ(mont.to_int(x), a);
+  EXPECT_EQ(mont.to_int(mont.multiply(x, y)), (a * b).mod(m));
+  EXPECT_EQ(mont.to_int(mont.add(x, y)), a + b - m);
+  EXPECT_EQ(mont.to_int(mont.subtract(x, y)), a - b + m);
+  EXPECT_EQ(mont.to_int(mont.subtract(y, x)), b - a);
+  EXPECT_EQ(mont.to_int(mont.pow(x, 77)), pow_mod(a, 77, m));
+  EXPECT_EQ(mont.pow(x, 0), mont.one());
+}
+
+TEST(ModularTest, SpecialFormModuli) {
+  const Int p25519{
+      "57896044618658097711785492504343953926634992332820282019728792003956"
+      "564819949"};
+  const Modulus modulus(p25519);
+  const Int a{"123456789012345678901234567890123456789012345678901234567890"};
+  const Int b = p25519 - 12345;
+  EXPECT_EQ(mul_mod(a, b, modulus), (a * b).mod(p25519));
+  EXPECT_EQ(mul_mod(-a, b, modulus), p25519 - (a * b).mod(p25519));
+  EXPECT_EQ(pow_mod(a, 77, modulus), naive_pow_mod(a, 77, p25519));
+  EXPECT_EQ(pow_mod(a, p25519 - 1, modulus), 1);
+  EXPECT_EQ(pow_mod(a, p25519 - 1, p25519), 1);
+  EXPECT_EQ(multi_pow_mod({a, b}, {5, 7}, modulus),
+            (naive_pow_mod(a, 5, p25519) * naive_pow_mod(b, 7, p25519))
+                .mod(p25519));
+  EXPECT_EQ((a * batch_inverse_mod({a}, p25519)[0]).mod(p25519), 1);
+
+  const Int m61{"2305843009213693951"};
+  EXPECT_EQ(pow_mod(3, m61 - 1, Modulus(m61)), 1);
+  EXPECT_EQ(mul_mod(m61 + 5, m61 - 2, Modulus(m61)), m61 - 10);
+
+  // Enough terms for Pippenger, and several inverses, modulo a Mersenne
+  // number whose top digit is full and one of a single digit.
+  for (const Int& m : {Int("340282366920938463463374607431768211455"),
+                       Int(127)}) {
+    std::vector<Int> bases;
+    std::vector<Int> exponents;
+    Int expected = 1;
+    for (uint32_t i = 0; i < 40; ++i) {
+      bases.push_back(m - 2 * i - 3);
+      exponents.push_back(i * 7 + 1);
+      expected =
+          (expected * naive_pow_mod(bases.back(), i * 7 + 1, m)).mod(m);
+    }
+    EXPECT_EQ(multi_pow_mod(bases, exponents, Modulus(m)), expected);
+    const std::vector<Int> units{m - 2, 2, m - 4};
+    const std::vector<Int> inverses = batch_inverse_mod(units, m);
+    for (size_t i = 0; i < units.size(); ++i) {
+      EXPECT_EQ((units[i] * inverses[i]).mod(m), 1);
+    }
+  }
+}
@@ -0,0 +1,342 @@
+#include "mpn.h"
+
+#include "integer_tuning.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace {
+// Karatsuba is never applied below this size, where the half sums would be no
+// shorter than the operands.
+const size_t kMinKaratsubaDigits = 4;
+}  // namespace
+
+namespace mpn {
+
+int cmp(const uint32_t* a, const uint32_t* b, size_t n) {
+  for (size_t i = n; i > 0; --i) {
+    if (a[i - 1] != b[i - 1]) {
+      return a[i - 1] < b[i - 1] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+size_t normalized_size(const uint32_t* a, size_t n) {
+  while (n > 0 && a[n - 1] == 0) {
+    --n;
+  }
+  return n;
+}
+
+size_t bit_length(const uint32_t* a, size_t n) {
+  n = normalized_size(a, n);
+  if (n == 0) {
+    return 0;
+  }
+  size_t bits = 32 * (n - 1);
+  for (uint32_t top = a[n - 1]; top != 0; top >>= 1) {
+    ++bits;
+  }
+  return bits;
+}
+
+uint32_t add_n(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    carry += static_cast<uint64_t>(a[i]) + b[i];
+    r[i] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  return static_cast<uint32_t>(carry);
+}
+
+uint32_t add(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+             size_t bn) {
+  assert(an >= bn);
+  uint32_t carry = add_n(r, a, b, bn);
+  for (size_t i = bn; i < an; ++i) {
+    r[i] = a[i] + carry;
+    carry = r[i] < carry ? 1 : 0;
+  }
+  return carry;
+}
+
+uint32_t sub_n(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n) {
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t diff = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+    r[i] = static_cast<uint32_t>(diff);
+    borrow = (diff >> 32) & 1U;
+  }
+  return static_cast<uint32_t>(borrow);
+}
+
+uint32_t sub(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+             size_t bn) {
+  assert(an >= bn);
+  uint32_t borrow = sub_n(r, a, b, bn);
+  for (size_t i = bn; i < an; ++i) {
+    const uint32_t digit = a[i];
+    r[i] = digit - borrow;
+    borrow = digit < borrow ? 1 : 0;
+  }
+  return borrow;
+}
+
+uint32_t mul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    carry += static_cast<uint64_t>(a[i]) * b;
+    r[i] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  return static_cast<uint32_t>(carry);
+}
+
+uint32_t addmul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    carry += static_cast<uint64_t>(a[i]) * b + r[i];
+    r[i] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  return static_cast<uint32_t>(carry);
+}
+
+uint32_t submul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b) {
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t product = static_cast<uint64_t>(a[i]) * b + borrow;
+    const uint32_t low = static_cast<uint32_t>(product);
+    borrow = (product >> 32) + (r[i] < low ? 1 : 0);
+    r[i] -= low;
+  }
+  return static_cast<uint32_t>(borrow);
+}
+
+uint32_t lshift(uint32_t* r, const uint32_t* a, size_t n, int shift) {
+  assert(shift >= 0 && shift < 32);
+  if (n == 0) {
+    return 0;
+  }
+  if (shift == 0) {
+    std::copy(a, a + n, r);
+    return 0;
+  }
+  // Walk down so that r may be a.
+  const uint32_t out = a[n - 1] >> (32 - shift);
+  for (size_t i = n - 1; i > 0; --i) {
+    r[i] = (a[i] << shift) | (a[i - 1] >> (32 - shift));
+  }
+  r[0] = a[0] << shift;
+  return out;
+}
+
+uint32_t rshift(uint32_t* r, const uint32_t* a, size_t n, int shift) {
+  assert(shift >= 0 && shift < 32);
+  if (n == 0) {
+    return 0;
+  }
+  if (shift == 0) {
+    std::copy(a, a + n, r);
+    return 0;
+  }
+  const uint32_t out = a[0] << (32 - shift);
+  for (size_t i = 0; i + 1 < n; ++i) {
+    r[i] = (a[i] >> shift) | (a[i + 1] << (32 - shift));
+  }
+  r[n - 1] = a[n - 1] >> shift;
+  return out;
+}
+
+// Karatsuba's own temporaries take at most 4(ceil(an / 2) + 1) digits and the
+// recursion works on operands of at most ceil(an / 2) + 1 digits, which keeps
+// the total within 8 * an.
+size_t mul_scratch_size(size_t an, size_t bn) {
+  assert(an >= bn);
+  return 8 * an;
+}
+
+void mul(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+         size_t bn, uint32_t* scratch) {
+  mul_karatsuba(r, a, an, b, bn, kMultiplyKaratsubaThreshold, scratch);
+}
+
+size_t sqr_scratch_size(size_t n) { return 8 * n; }
+
+void sqr(uint32_t* r, const uint32_t* a, size_t n, uint32_t* scratch) {
+  sqr_karatsuba(r, a, n, kSquareKaratsubaThreshold, scratch);
+}
+
+void mul_basecase(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+                  size_t bn) {
+  assert(an >= bn && bn >= 1);
+  r[an] = mul_1(r, a, an, b[0]);
+  for (size_t i = 1; i < bn; ++i) {
+    r[i + an] = addmul_1(r + i, a, an, b[i]);
+  }
+}
+
+void mul_karatsuba(uint32_t* r, const uint32_t* a, size_t an,
+                   const uint32_t* b, size_t bn, size_t threshold,
+                   uint32_t* scratch) {
+  assert(an >= bn && bn >= 1);
+  if (bn < std::max(threshold, kMinKaratsubaDigits)) {
+    mul_basecase(r, a, an, b, bn);
+    return;
+  }
+  if (2 * bn <= an) {
+    // Very unbalanced operands: multiply b by each b sized block of a.
+    uint32_t* block_product = scratch;
+    uint32_t* rest = scratch + 2 * bn;
+    std::fill(r, r + an + bn, 0);
+    for (size_t i = 0; i < an; i += bn) {
+      const size_t block = std::min(bn, an - i);
+      if (block == bn) {
+        mul_karatsuba(block_product, a + i, bn, b, bn, threshold, rest);
+      } else {
+        mul_karatsuba(block_product, b, bn, a + i, block, threshold, rest);
+      }
+      add(r + i, r + i, an + bn - i, block_product, block + bn);
+    }
+    return;
+  }
+  // With a = a1 * B^h + a0 and b = b1 * B^h + b0, the middle coefficient
+  // a1 * b0 + a0 * b1 is (a0 + a1)(b0 + b1) - a0 * b0 - a1 * b1. Since
+  // an < 2 bn, b1 is not empty, and a1 is at least as long as every other
+  // part.
+  const size_t h = an / 2;
+  const size_t a1n = an - h;
+  const size_t b1n = bn - h;
+  uint32_t* a_sum = scratch;
+  uint32_t* b_sum = a_sum + a1n + 1;
+  uint32_t* z1 = b_sum + a1n + 1;
+  uint32_t* rest = z1 + 2 * a1n + 2;
+  a_sum[a1n] = add(a_sum, a + h, a1n, a, h);
+  size_t b_sum_n;
+  if (b1n >= h) {
+    b_sum[b1n] = add(b_sum, b + h, b1n, b, h);
+    b_sum_n = b1n + 1;
+  } else {
+    b_sum[h] = add(b_sum, b, h, b + h, b1n);
+    b_sum_n = h + 1;
+  }
+  mul_karatsuba(r, a, h, b, h, threshold, rest);
+  mul_karatsuba(r + 2 * h, a + h, a1n, b + h, b1n, threshold, rest);
+  size_t z1n = a1n + 1 + b_sum_n;
+  mul_karatsuba(z1, a_sum, a1n + 1, b_sum, b_sum_n, threshold, rest);
+  sub(z1, z1, z1n, r, 2 * h);
+  sub(z1, z1, z1n, r + 2 * h, an + bn - 2 * h);
+  z1n = normalized_size(z1, z1n);
+  assert(z1n <= an + bn - h);
+  add(r + h, r + h, an + bn - h, z1, z1n);
+}
+
+void sqr_basecase(uint32_t* r, const uint32_t* a, size_t n) {
+  assert(n >= 1);
+  // Sum the products a[i] * a[j] with i < j once...
+  std::fill(r, r + 2 * n, 0);
+  for (size_t i = 0; i + 1 < n; ++i) {
+    r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+  }
+  // ...double them...
+  lshift(r, r, 2 * n, 1);
+  // ...and add the squares on the diagonal.
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t square = static_cast<uint64_t>(a[i]) * a[i];
+    uint64_t sum = r[2 * i] + (square & 0xFFFFFFFFULL) + carry;
+    r[2 * i] = static_cast<uint32_t>(sum);
+    sum = r[2 * i + 1] + (square >> 32) + (sum >> 32);
+    r[2 * i + 1] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+}
+
+void sqr_karatsuba(uint32_t* r, const uint32_t* a, size_t n, size_t threshold,
+                   uint32_t* scratch) {
+  assert(n >= 1);
+  if (n < std::max(threshold, kMinKaratsubaDigits)) {
+    sqr_basecase(r, a, n);
+    return;
+  }
+  const size_t h = n / 2;
+  const size_t a1n = n - h;
+  uint32_t* a_sum = scratch;
+  uint32_t* z1 = a_sum + a1n + 1;
+  uint32_t* rest = z1 + 2 * a1n + 2;
+  a_sum[a1n] = add(a_sum, a + h, a1n, a, h);
+  sqr_karatsuba(r, a, h, threshold, rest);
+  sqr_karatsuba(r + 2 * h, a + h, a1n, threshold, rest);
+  size_t z1n = 2 * a1n + 2;
+  sqr_karatsuba(z1, a_sum, a1n + 1, threshold, rest);
+  sub(z1, z1, z1n, r, 2 * h);
+  sub(z1, z1, z1n, r + 2 * h, 2 * a1n);
+  z1n = normalized_size(z1, z1n);
+  assert(z1n <= 2 * n - h);
+  add(r + h, r + h, 2 * n - h, z1, z1n);
+}
+
+uint32_t divrem_1(uint32_t* q, const uint32_t* a, size_t n, uint32_t d) {
+  assert(d != 0);
+  uint64_t remainder = 0;
+  for (size_t i = n; i > 0; --i) {
+    const uint64_t current = (remainder << 32) | a[i - 1];
+    q[i - 1] = static_cast<uint32_t>(current / d);
+    remainder = current % d;
+  }
+  return static_cast<uint32_t>(remainder);
+}
+
+size_t divrem_scratch_size(size_t an, size_t dn) { return an + 1 + dn; }
+
+void divrem(uint32_t* q, uint32_t* r, const uint32_t* a, size_t an,
+            const uint32_t* d, size_t dn, uint32_t* scratch) {
+  assert(an >= dn && dn >= 1 && d[dn - 1] != 0);
+  if (dn == 1) {
+    r[0] = divrem_1(q, a, an, d[0]);
+    return;
+  }
+  // Shift both operands so that the top bit of the divisor is set. Then each
+  // estimate of a quotient digit from the top two digits, corrected with the
+  // third, is at most one too large.
+  int s = 0;
+  while (((d[dn - 1] << s) & 0x80000000U) == 0) {
+    ++s;
+  }
+  uint32_t* u = scratch;
+  uint32_t* v = scratch + an + 1;
+  lshift(v, d, dn, s);
+  u[an] = lshift(u, a, an, s);
+  const uint64_t v1 = v[dn - 1];
+  const uint64_t v2 = v[dn - 2];
+  for (size_t j = an - dn + 1; j > 0; --j) {
+    uint32_t* window = u + j - 1;
+    const uint64_t top = (static_cast<uint64_t>(window[dn]) << 32) |
+                         window[dn - 1];
+    uint64_t q_hat = top / v1;
+    uint64_t r_hat = top % v1;
+    while (q_hat > 0xFFFFFFFFULL ||
+           q_hat * v2 > ((r_hat << 32) | window[dn - 2])) {
+      --q_hat;
+      r_hat += v1;
+      if (r_hat > 0xFFFFFFFFULL) {
+        break;
+      }
+    }
+    const uint32_t borrow =
+        submul_1(window, v, dn, static_cast<uint32_t>(q_hat));
+    const bool too_large = window[dn] < borrow;
+    window[dn] -= borrow;
+    if (too_large) {
+      --q_hat;
+      window[dn] += add_n(window, window, v, dn);
+    }
+    q[j - 1] = static_cast<uint32_t>(q_hat);
+  }
+  rshift(r, u, dn, s);
+}
+
+}  // namespace mpn
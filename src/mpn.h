@@ -0,0 +1,86 @@
+#ifndef NUMBER_SRC_MPN_H
+#define NUMBER_SRC_MPN_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Natural number arithmetic on caller owned spans of base 2^32 digits, least
+// significant first, in the style of GMP's mpn layer. Nothing here allocates:
+// functions that need temporary space take a scratch span whose size is given
+// by the matching *_scratch_size function. Sizes are digit counts, and spans
+// may have leading zeros unless stated otherwise.
+namespace mpn {
+
+// Compares a and b, both of n digits. Returns -1, 0 or 1.
+int cmp(const uint32_t* a, const uint32_t* b, size_t n);
+
+// Returns n without the leading zero digits of a.
+size_t normalized_size(const uint32_t* a, size_t n);
+// Returns the number of significant bits of a.
+size_t bit_length(const uint32_t* a, size_t n);
+
+// Writes a + b to r, all of n digits, and returns the carry. r may be a or b.
+uint32_t add_n(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n);
+// Writes a + b to r, which has an digits. Requires an >= bn. r may be a.
+uint32_t add(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+             size_t bn);
+
+// Writes a - b to r, all of n digits, and returns the borrow. r may be a or b.
+uint32_t sub_n(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n);
+// Writes a - b to r, which has an digits. Requires an >= bn. r may be a.
+uint32_t sub(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+             size_t bn);
+
+// Writes a * b to r, both of n digits, and returns the high digit. r may be
+// a.
+uint32_t mul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b);
+// Adds a * b to r, both of n digits, and returns the carry.
+uint32_t addmul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b);
+// Subtracts a * b from r, both of n digits, and returns the borrow.
+uint32_t submul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b);
+
+// Writes a << shift to r, both of n digits, and returns the bits shifted out
+// of the top in the low bits of the result. Requires shift < 32. r may be a.
+uint32_t lshift(uint32_t* r, const uint32_t* a, size_t n, int shift);
+// Writes a >> shift to r, both of n digits, and returns the bits shifted out
+// of the bottom in the high bits of the result. Requires shift < 32. r may be
+// a.
+uint32_t rshift(uint32_t* r, const uint32_t* a, size_t n, int shift);
+
+// Writes a * b to r, which has an + bn digits and must not overlap a or b.
+// Requires an >= bn >= 1. Karatsuba multiplication is used from the
+// threshold in integer_tuning.h.
+size_t mul_scratch_size(size_t an, size_t bn);
+void mul(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+         size_t bn, uint32_t* scratch);
+// Writes a^2 to r, which has 2n digits and must not overlap a. Requires
+// n >= 1.
+size_t sqr_scratch_size(size_t n);
+void sqr(uint32_t* r, const uint32_t* a, size_t n, uint32_t* scratch);
+
+// The tiers behind mul and sqr, exposed so that the tuner can time each one.
+// The Karatsuba versions recurse until the shorter operand has fewer than
+// threshold digits and take the same scratch as mul and sqr.
+void mul_basecase(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b,
+                  size_t bn);
+void mul_karatsuba(uint32_t* r, const uint32_t* a, size_t an,
+                   const uint32_t* b, size_t bn, size_t threshold,
+                   uint32_t* scratch);
+void sqr_basecase(uint32_t* r, const uint32_t* a, size_t n);
+void sqr_karatsuba(uint32_t* r, const uint32_t* a, size_t n, size_t threshold,
+                   uint32_t* scratch);
+
+// Writes a / d to q, which has n digits, and returns a mod d. Requires
+// d != 0. q may be a.
+uint32_t divrem_1(uint32_t* q, const uint32_t* a, size_t n, uint32_t d);
+// Writes the quotient a / d to q, which has an - dn + 1 digits, and the
+// remainder to r, which has dn digits, using Knuth's algorithm D. Requires
+// an >= dn >= 1 and a nonzero top digit of d. q and r must not overlap each
+// other, a or d.
+size_t divrem_scratch_size(size_t an, size_t dn);
+void divrem(uint32_t* q, uint32_t* r, const uint32_t* a, size_t an,
+            const uint32_t* d, size_t dn, uint32_t* scratch);
+
+}  // namespace mpn
+
+#endif  // NUMBER_SRC_MPN_H
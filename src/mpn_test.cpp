@@ -0,0 +1,176 @@
+#include "mpn.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "integer.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "gtest/gtest.h"
+#pragma clang diagnostic pop
+
+namespace {
+// Written past the end of scratch space to catch overruns.
+const uint32_t kGuard = 0xDEADBEEF;
+
+std::vector<uint32_t> random_digits(std::mt19937* gen, size_t n) {
+  std::vector<uint32_t> digits(n);
+  for (uint32_t& digit : digits) {
+    digit = (*gen)();
+  }
+  return digits;
+}
+
+// Scratch space of the given size filled with garbage and followed by a guard
+// digit.
+std::vector<uint32_t> scratch_space(size_t n) {
+  std::vector<uint32_t> scratch(n + 1, 0x5A5A5A5A);
+  scratch[n] = kGuard;
+  return scratch;
+}
+
+std::vector<uint32_t> mul_digits(const std::vector<uint32_t>& a,
+                                 const std::vector<uint32_t>& b) {
+  if (a.size() < b.size()) {
+    return mul_digits(b, a);
+  }
+  std::vector<uint32_t> r(a.size() + b.size());
+  mpn::mul_basecase(r.data(), a.data(), a.size(), b.data(), b.size());
+  return r;
+}
+}  // namespace
+
+TEST(MpnTest, AddSubCmp) {
+  const std::vector<uint32_t> a{0xFFFFFFFF, 0xFFFFFFFF, 7};
+  const std::vector<uint32_t> b{1, 0, 0};
+  std::vector<uint32_t> r(3);
+  EXPECT_EQ(mpn::add_n(r.data(), a.data(), b.data(), 3), 0);
+  EXPECT_EQ(r, std::vector<uint32_t>({0, 0, 8}));
+  EXPECT_EQ(mpn::sub_n(r.data(), r.data(), b.data(), 3), 0);
+  EXPECT_EQ(r, a);
+  EXPECT_EQ(mpn::sub_n(r.data(), b.data(), a.data(), 3), 1);
+  EXPECT_EQ(mpn::add(r.data(), a.data(), 3, b.data(), 1), 0);
+  EXPECT_EQ(r, std::vector<uint32_t>({0, 0, 8}));
+  EXPECT_EQ(mpn::sub(r.data(), r.data(), 3, b.data(), 1), 0);
+  EXPECT_EQ(r, a);
+  EXPECT_EQ(mpn::add(r.data(), a.data(), 2, b.data(), 1), 1);
+
+  EXPECT_EQ(mpn::cmp(a.data(), b.data(), 3), 1);
+  EXPECT_EQ(mpn::cmp(b.data(), a.data(), 3), -1);
+  EXPECT_EQ(mpn::cmp(a.data(), a.data(), 3), 0);
+  const std::vector<uint32_t> padded{5, 0, 0};
+  EXPECT_EQ(mpn::normalized_size(padded.data(), 3), 1);
+  EXPECT_EQ(mpn::normalized_size(padded.data() + 1, 2), 0);
+}
+
+TEST(MpnTest, SingleDigitAndShifts) {
+  std::mt19937 gen(1);
+  const std::vector<uint32_t> a = random_digits(&gen, 20);
+  const uint32_t b = gen();
+  std::vector<uint32_t> r(20);
+  const uint32_t high = mpn::mul_1(r.data(), a.data(), 20, b);
+  std::vector<uint32_t> with_high = r;
+  with_high.push_back(high);
+  EXPECT_EQ(Int(with_high), Int(a) * Int(std::vector<uint32_t>{b}));
+
+  std::vector<uint32_t> acc(20, 0);
+  EXPECT_EQ(mpn::addmul_1(acc.data(), a.data(), 20, b), high);
+  EXPECT_EQ(acc, r);
+  EXPECT_EQ(mpn::submul_1(acc.data(), a.data(), 20, b), high);
+  EXPECT_EQ(acc, std::vector<uint32_t>(20, 0));
+
+  std::vector<uint32_t> q(21);
+  EXPECT_EQ(mpn::divrem_1(q.data(), with_high.data(), 21, b + 1),
+            Int(with_high).mod_ui(DigitDivisor(b + 1)));
+  Int quotient(with_high);
+  quotient.divmod_ui(b + 1);
+  EXPECT_EQ(Int(q), quotient);
+
+  for (const int shift : {0, 1, 13, 31}) {
+    std::vector<uint32_t> shifted(21);
+    shifted[20] = mpn::lshift(shifted.data(), a.data(), 20, shift);
+    Int expected(a);
+    for (int i = 0; i < shift; ++i) {
+      expected *= 2;
+    }
+    EXPECT_EQ(Int(shifted), expected);
+    std::vector<uint32_t> back(21);
+    EXPECT_EQ(mpn::rshift(back.data(), shifted.data(), 21, shift), 0);
+    back.pop_back();
+    EXPECT_EQ(back, a);
+    // Shifting in place.
+    mpn::lshift(back.data(), back.data(), 20, shift);
+    mpn::rshift(back.data(), back.data(), 20, shift);
+    EXPECT_EQ(back[0], a[0]);
+  }
+  EXPECT_EQ(mpn::rshift(r.data(), std::vector<uint32_t>{6}.data(), 1, 2),
+            0x80000000U);
+}
+
+TEST(MpnTest, Multiplication) {
+  std::mt19937 gen(42);
+  const size_t sizes[] = {1, 2, 3, 7, 16, 33, 64, 65, 150};
+  for (const size_t m : sizes) {
+    for (const size_t n : sizes) {
+      if (n > m) {
+        continue;
+      }
+      std::vector<uint32_t> a = random_digits(&gen, m);
+      const std::vector<uint32_t> b = random_digits(&gen, n);
+      a.back() = 0xFFFFFFFF;
+      const std::vector<uint32_t> expected = mul_digits(a, b);
+      for (const size_t threshold : {2, 8, 1000}) {
+        std::vector<uint32_t> r(m + n);
+        std::vector<uint32_t> scratch =
+            scratch_space(mpn::mul_scratch_size(m, n));
+        mpn::mul_karatsuba(r.data(), a.data(), m, b.data(), n, threshold,
+                           scratch.data());
+        EXPECT_EQ(r, expected);
+        EXPECT_EQ(scratch.back(), kGuard);
+
+        std::vector<uint32_t> square(2 * m);
+        scratch = scratch_space(mpn::sqr_scratch_size(m));
+        mpn::sqr_karatsuba(square.data(), a.data(), m, threshold,
+                           scratch.data());
+        EXPECT_EQ(square, mul_digits(a, a));
+        EXPECT_EQ(scratch.back(), kGuard);
+      }
+      std::vector<uint32_t> square(2 * m);
+      mpn::sqr_basecase(square.data(), a.data(), m);
+      EXPECT_EQ(square, mul_digits(a, a));
+    }
+  }
+}
+
+TEST(MpnTest, Division) {
+  std::mt19937 gen(3);
+  for (const size_t an : {2, 3, 10, 40}) {
+    for (const size_t dn : {1, 2, 3, 9, 40}) {
+      if (dn > an) {
+        continue;
+      }
+      for (int trial = 0; trial < 20; ++trial) {
+        std::vector<uint32_t> a = random_digits(&gen, an);
+        std::vector<uint32_t> d = random_digits(&gen, dn);
+        // Small top digits and runs of ones exercise the quotient correction.
+        d.back() = trial % 2 == 0 ? (d.back() >> (gen() % 32)) | 1
+                                  : 0x80000000U;
+        if (trial % 3 == 0) {
+          std::fill(a.begin(), a.end(), 0xFFFFFFFF);
+        }
+        std::vector<uint32_t> q(an - dn + 1);
+        std::vector<uint32_t> r(dn);
+        std::vector<uint32_t> scratch =
+            scratch_space(mpn::divrem_scratch_size(an, dn));
+        mpn::divrem(q.data(), r.data(), a.data(), an, d.data(), dn,
+                    scratch.data());
+        EXPECT_EQ(scratch.back(), kGuard);
+        const Int remainder(r);
+        EXPECT_EQ(Int(mul_digits(d, q)) + remainder, Int(a));
+        EXPECT_TRUE(remainder < Int(d));
+      }
+    }
+  }
+}
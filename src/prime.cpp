@@ -0,0 +1,353 @@
+#include "prime.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "modular.h"
+#include "product.h"
+
+namespace {
+// Primes up to this bound are used for trial division before any
+// probabilistic test.
+const uint32_t kTrialDivisionBound = 1000;
+
+// Odd primes up to this bound are used to sieve windows in next_prime.
+const uint32_t kSieveBound = 1 << 16;
+
+// Number of odd candidates sieved at a time by next_prime.
+const uint32_t kSieveWindow = 1 << 12;
+
+// Search this many Selfridge parameters before checking whether n is a
+// perfect square, for which no parameter with Jacobi symbol -1 exists.
+const int kSquareCheckAfter = 10;
+
+enum class TrialDivision { kComposite, kPrime, kUnknown };
+
+const std::vector<uint32_t>& trial_primes() {
+  static const std::vector<uint32_t> primes = primes_up_to(kTrialDivisionBound);
+  return primes;
+}
+
+const std::vector<uint32_t>& sieve_primes() {
+  static const std::vector<uint32_t> primes = [] {
+    std::vector<uint32_t> odd_primes = primes_up_to(kSieveBound);
+    odd_primes.erase(odd_primes.begin());
+    return odd_primes;
+  }();
+  return primes;
+}
+
+uint32_t lowest_digit(const Int& n) { return n.get_digits()[0]; }
+
+// Returns a uniformly random base in [2, n - 2], up to a bias of at most
+// 2^-32, drawn from a generator seeded by std::random_device so that the
+// bases cannot be predicted by whoever chose n. Requires n > 4.
+Int random_base(const Int& n) {
+  thread_local std::mt19937 gen{std::random_device{}()};
+  std::vector<uint32_t> digits(n.get_digits().size() + 1);
+  for (uint32_t& digit : digits) {
+    digit = gen();
+  }
+  return Int(digits).mod(n - 3) + 2;
+}
+
+TrialDivision trial_division(const Int& n) {
+  if (n < 2) {
+    return TrialDivision::kComposite;
+  }
+  const std::vector<uint32_t>& primes = trial_primes();
+  const std::vector<uint32_t>& digits = n.get_digits();
+  if (digits.size() == 1 && digits[0] <= kTrialDivisionBound) {
+    return std::binary_search(primes.begin(), primes.end(), digits[0])
+               ? TrialDivision::kPrime
+               : TrialDivision::kComposite;
+  }
+  for (const uint32_t r : residues(n, primes)) {
+    if (r == 0) {
+      return TrialDivision::kComposite;
+    }
+  }
+  // A composite number has a prime factor at most its square root.
+  if (digits.size() == 1 &&
+      digits[0] < kTrialDivisionBound * kTrialDivisionBound) {
+    return TrialDivision::kPrime;
+  }
+  return TrialDivision::kUnknown;
+}
+
+// Returns the Jacobi symbol (a/n) for odd n > 0 and a < n.
+int small_jacobi(uint64_t a, uint64_t n) {
+  int result = 1;
+  while (a != 0) {
+    while (a % 2 == 0) {
+      a /= 2;
+      if (n % 8 == 3 || n % 8 == 5) {
+        result = -result;
+      }
+    }
+    std::swap(a, n);
+    if (a % 4 == 3 && n % 4 == 3) {
+      result = -result;
+    }
+    a %= n;
+  }
+  return n == 1 ? result : 0;
+}
+
+// Returns the Jacobi symbol (a/n) for odd n > 0 and 0 < |a| < 2^32.
+int jacobi(int64_t a, const Int& n) {
+  const uint32_t n_mod_8 = lowest_digit(n) & 7U;
+  int result = 1;
+  if (a < 0) {
+    a = -a;
+    if (n_mod_8 % 4 == 3) {
+      result = -result;
+    }
+  }
+  while (a % 2 == 0) {
+    a /= 2;
+    if (n_mod_8 == 3 || n_mod_8 == 5) {
+      result = -result;
+    }
+  }
+  if (a == 1) {
+    return result;
+  }
+  // Quadratic reciprocity turns (a/n) into (n mod a / a).
+  if (a % 4 == 3 && n_mod_8 % 4 == 3) {
+    result = -result;
+  }
+  const uint32_t small_a = static_cast<uint32_t>(a);
+  return result * small_jacobi(n.mod_ui(DigitDivisor(small_a)), small_a);
+}
+
+// Returns floor(sqrt(n)) for n >= 0 using Newton's method.
+Int isqrt(const Int& n) {
+  if (n < 2) {
+    return n;
+  }
+  // Start from a power of two above the square root.
+  const size_t digits = n.get_digits().size();
+  std::vector<uint32_t> start((digits + 1) / 2 + 1, 0);
+  start.back() = 1;
+  Int x(start);
+  while (true) {
+    Int y = x + n / x;
+    y.divmod_ui(2);
+    if (y >= x) {
+      return x;
+    }
+    x = y;
+  }
+}
+
+// Writes a = d * 2^s with d odd. Requires a > 0.
+void split_power_of_two(const Int& a, Int* d, int* s) {
+  *d = a;
+  *s = 0;
+  while ((lowest_digit(*d) & 1U) == 0) {
+    d->divmod_ui(2);
+    ++*s;
+  }
+}
+
+// n is an odd number greater than kTrialDivisionBound with no small factors,
+// and n - 1 = d * 2^s with d odd.
+bool strong_probable_prime(const Montgomery& mont, const Int& base,
+                           const Int& d, int s) {
+  const Montgomery::Element zero = mont.subtract(mont.one(), mont.one());
+  const Montgomery::Element minus_one = mont.subtract(zero, mont.one());
+  Montgomery::Element x = mont.pow(mont.from_int(base), d);
+  if (x == mont.one() || x == minus_one) {
+    return true;
+  }
+  for (int r = 1; r < s; ++r) {
+    x = mont.multiply(x, x);
+    if (x == minus_one) {
+      return true;
+    }
+    if (x == mont.one()) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// Returns the element of mont representing the small signed integer a, which
+// must satisfy |a| < n.
+Montgomery::Element small_element(const Montgomery& mont, const Int& n,
+                                  int64_t a) {
+  assert(std::llabs(a) < 0x80000000LL);
+  const Int magnitude(static_cast<int32_t>(std::llabs(a)));
+  return mont.from_int(a < 0 ? n - magnitude : magnitude);
+}
+
+// The strong Lucas probable prime test with P = 1 and Q = (1 - D) / 4, where D
+// is the first of 5, -7, 9, -11, ... with Jacobi symbol (D/n) = -1.
+bool strong_lucas_probable_prime(const Montgomery& mont, const Int& n) {
+  int64_t d_param = 5;
+  for (int attempt = 1;; ++attempt) {
+    const int j = jacobi(d_param, n);
+    if (j == -1) {
+      break;
+    }
+    if (j == 0) {
+      // n has no factors below kTrialDivisionBound, so it is larger than |D|
+      // and shares a factor with it.
+      return false;
+    }
+    if (attempt == kSquareCheckAfter) {
+      const Int root = isqrt(n);
+      if (root * root == n) {
+        return false;
+      }
+    }
+    d_param = d_param > 0 ? -(d_param + 2) : -d_param + 2;
+  }
+  const int64_t q_param = (1 - d_param) / 4;
+
+  Int d{0};
+  int s = 0;
+  split_power_of_two(n + 1, &d, &s);
+
+  using Element = Montgomery::Element;
+  const Element big_d = small_element(mont, n, d_param);
+  const Element q = small_element(mont, n, q_param);
+  Int half_int = n + 1;
+  half_int.divmod_ui(2);
+  const Element half = mont.from_int(half_int);
+
+  // Walk the bits of d from the top, keeping U_k, V_k and Q^k.
+  Element u = mont.subtract(mont.one(), mont.one());
+  Element v = mont.add(mont.one(), mont.one());
+  Element q_k = mont.one();
+  const std::vector<uint32_t>& d_digits = d.get_digits();
+  for (size_t bit = 32 * d_digits.size(); bit > 0; --bit) {
+    u = mont.multiply(u, v);
+    v = mont.subtract(mont.multiply(v, v), mont.add(q_k, q_k));
+    q_k = mont.multiply(q_k, q_k);
+    if ((d_digits[(bit - 1) / 32] >> ((bit - 1) % 32)) & 1U) {
+      const Element next_u = mont.multiply(mont.add(u, v), half);
+      v = mont.multiply(mont.add(mont.multiply(big_d, u), v), half);
+      u = next_u;
+      q_k = mont.multiply(q_k, q);
+    }
+  }
+
+  const Element zero = mont.subtract(mont.one(), mont.one());
+  if (u == zero) {
+    return true;
+  }
+  for (int r = 0; r < s; ++r) {
+    if (v == zero) {
+      return true;
+    }
+    v = mont.subtract(mont.multiply(v, v), mont.add(q_k, q_k));
+    q_k = mont.multiply(q_k, q_k);
+  }
+  return false;
+}
+}  // namespace
+
+bool miller_rabin_test(const Int& n, int rounds) {
+  if (rounds <= 0) {
+    throw std::invalid_argument("rounds must be positive");
+  }
+  const TrialDivision trial = trial_division(n);
+  if (trial != TrialDivision::kUnknown) {
+    return trial == TrialDivision::kPrime;
+  }
+  const Montgomery mont(n);
+  Int d{0};
+  int s = 0;
+  split_power_of_two(n - 1, &d, &s);
+  for (int i = 0; i < rounds; ++i) {
+    if (!strong_probable_prime(mont, random_base(n), d, s)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool baillie_psw_test(const Int& n) {
+  const TrialDivision trial = trial_division(n);
+  if (trial != TrialDivision::kUnknown) {
+    return trial == TrialDivision::kPrime;
+  }
+  const Montgomery mont(n);
+  Int d{0};
+  int s = 0;
+  split_power_of_two(n - 1, &d, &s);
+  return strong_probable_prime(mont, 2, d, s) &&
+         strong_lucas_probable_prime(mont, n);
+}
+
+std::vector<bool> batch_baillie_psw_test(const std::vector<Int>& candidates,
+                                         unsigned num_threads) {
+  // Each thread writes whole bytes so that no two threads share a word.
+  std::vector<char> results(candidates.size(), 0);
+  num_threads = std::max(1U, std::min<unsigned>(num_threads,
+                                                 candidates.size()));
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&candidates, &results, t, num_threads] {
+      for (size_t i = t; i < candidates.size(); i += num_threads) {
+        results[i] = baillie_psw_test(candidates[i]);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return std::vector<bool>(results.begin(), results.end());
+}
+
+Int next_prime(const Int& n) {
+  if (n < 2) {
+    return 2;
+  }
+  Int start = n + 1;
+  if ((lowest_digit(start) & 1U) == 0) {
+    start += 1;
+  }
+  const std::vector<uint32_t>& primes = sieve_primes();
+  // Below the sieve bound a candidate could be one of the sieving primes
+  // itself, and testing each candidate directly is cheap anyway.
+  while (start <= static_cast<int32_t>(kSieveBound)) {
+    if (baillie_psw_test(start)) {
+      return start;
+    }
+    start += 2;
+  }
+  std::vector<bool> composite(kSieveWindow);
+  while (true) {
+    // Offset i stands for the odd candidate start + 2i.
+    std::fill(composite.begin(), composite.end(), false);
+    const std::vector<uint32_t> start_residues = residues(start, primes);
+    for (size_t j = 0; j < primes.size(); ++j) {
+      const uint64_t p = primes[j];
+      // Solve start + 2i = 0 mod p using 2^-1 = (p + 1) / 2 mod p.
+      const uint64_t first =
+          (p - start_residues[j]) % p * ((p + 1) / 2) % p;
+      for (uint64_t i = first; i < kSieveWindow; i += p) {
+        composite[i] = true;
+      }
+    }
+    for (uint32_t i = 0; i < kSieveWindow; ++i) {
+      if (composite[i]) {
+        continue;
+      }
+      const Int candidate = start + Int(static_cast<int32_t>(2 * i));
+      if (baillie_psw_test(candidate)) {
+        return candidate;
+      }
+    }
+    start += Int(static_cast<int32_t>(2 * kSieveWindow));
+  }
+}
@@ -0,0 +1,30 @@
+#ifndef NUMBER_SRC_PRIME_H
+#define NUMBER_SRC_PRIME_H
+
+#include <vector>
+
+#include "integer.h"
+
+// Returns false if n is certainly composite (or less than 2) and true if n is
+// probably prime. Small factors are removed by trial division, then n is
+// checked with the Miller-Rabin test to rounds bases drawn at random from
+// [2, n - 2], so a composite n passes with probability at most 4^-rounds
+// however it was chosen. Throws std::invalid_argument if rounds <= 0.
+bool miller_rabin_test(const Int& n, int rounds = 25);
+
+// Like miller_rabin_test but uses the Baillie-PSW test: a Miller-Rabin test to
+// base 2 followed by a strong Lucas test with Selfridge's parameters. No
+// composite number is known to pass it.
+bool baillie_psw_test(const Int& n);
+
+// Runs baillie_psw_test on every candidate, spreading the candidates over
+// num_threads threads.
+std::vector<bool> batch_baillie_psw_test(const std::vector<Int>& candidates,
+                                         unsigned num_threads = 1);
+
+// Returns the smallest probable prime strictly greater than n. Candidates are
+// sieved by small primes a window at a time so that only the survivors are
+// tested with baillie_psw_test.
+Int next_prime(const Int& n);
+
+#endif  // NUMBER_SRC_PRIME_H
@@ -0,0 +1,108 @@
+#include "prime.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "integer.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "gtest/gtest.h"
+#pragma clang diagnostic pop
+
+namespace {
+bool is_prime_by_trial_division(int32_t n) {
+  if (n < 2) {
+    return false;
+  }
+  for (int32_t d = 2; d * d <= n; ++d) {
+    if (n % d == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 2^127 - 1 and 2^89 - 1 are Mersenne primes.
+const Int m127{"170141183460469231731687303715884105727"};
+const Int m89{"618970019642690137449562111"};
+}  // namespace
+
+TEST(PrimeTest, SmallNumbers) {
+  for (int32_t n = -5; n < 3000; ++n) {
+    EXPECT_EQ(miller_rabin_test(n), is_prime_by_trial_division(n)) << n;
+    EXPECT_EQ(baillie_psw_test(n), is_prime_by_trial_division(n)) << n;
+  }
+  for (int32_t n = 1000000; n < 1001000; ++n) {
+    EXPECT_EQ(baillie_psw_test(n), is_prime_by_trial_division(n)) << n;
+  }
+}
+
+TEST(PrimeTest, LargePrimes) {
+  EXPECT_TRUE(miller_rabin_test(m127));
+  EXPECT_TRUE(baillie_psw_test(m127));
+  EXPECT_TRUE(baillie_psw_test(m89));
+  EXPECT_TRUE(baillie_psw_test(Int{"18446744073709551629"}));
+  EXPECT_FALSE(baillie_psw_test(m127 * m89));
+  EXPECT_FALSE(miller_rabin_test(m127 * m89));
+  EXPECT_FALSE(baillie_psw_test(m89 * m89));
+  EXPECT_FALSE(baillie_psw_test(Int{1000003} * Int{1000003}));
+}
+
+TEST(PrimeTest, Pseudoprimes) {
+  // None of these has a prime factor below 1000, so trial division passes
+  // them on to the probabilistic tests. Random bases catch composites that
+  // fool every small prime base; each check below fails spuriously with
+  // probability at most 4^-25.
+  // 149491 * 747451 * 34233211 is a strong pseudoprime to every prime base up
+  // to 23.
+  const Int a{"3825123056546413051"};
+  EXPECT_FALSE(miller_rabin_test(a));
+  EXPECT_FALSE(baillie_psw_test(a));
+  // 399165290221 * 798330580441 is a strong pseudoprime to every prime base
+  // up to 37.
+  const Int b{"318665857834031151167461"};
+  EXPECT_FALSE(miller_rabin_test(b));
+  EXPECT_FALSE(baillie_psw_test(b));
+  // 1021 * 3061 and 1061 * 3181 are strong pseudoprimes to base 2, so only
+  // the Lucas half of Baillie-PSW rejects them.
+  for (const int32_t n : {3125281, 3375041}) {
+    EXPECT_FALSE(miller_rabin_test(n)) << n;
+    EXPECT_FALSE(baillie_psw_test(n)) << n;
+  }
+
+  EXPECT_TRUE(miller_rabin_test(1000003, 1));
+  EXPECT_THROW(miller_rabin_test(1000003, 0), std::invalid_argument);
+  EXPECT_THROW(miller_rabin_test(1000003, -1), std::invalid_argument);
+}
+
+TEST(PrimeTest, BatchBailliePsw) {
+  std::vector<Int> candidates;
+  std::vector<bool> expected;
+  for (int32_t n = 990000; n < 990200; ++n) {
+    candidates.push_back(n);
+    expected.push_back(is_prime_by_trial_division(n));
+  }
+  candidates.push_back(m127);
+  expected.push_back(true);
+  EXPECT_EQ(batch_baillie_psw_test(candidates), expected);
+  EXPECT_EQ(batch_baillie_psw_test(candidates, 4), expected);
+  EXPECT_TRUE(batch_baillie_psw_test({}, 4).empty());
+}
+
+TEST(PrimeTest, NextPrime) {
+  EXPECT_EQ(next_prime(-10), 2);
+  EXPECT_EQ(next_prime(2), 3);
+  EXPECT_EQ(next_prime(3), 5);
+  EXPECT_EQ(next_prime(100), 101);
+  EXPECT_EQ(next_prime(65520), 65521);
+  EXPECT_EQ(next_prime(65521), 65537);
+  EXPECT_EQ(next_prime(65537), 65539);
+  EXPECT_EQ(next_prime(1000000), 1000003);
+  EXPECT_EQ(next_prime(Int{"100000000000000000000"}),
+            Int{"100000000000000000039"});
+  EXPECT_EQ(next_prime(Int{"18446744073709551616"}),
+            Int{"18446744073709551629"});
+  EXPECT_EQ(next_prime(m127 - 2), m127);
+}
@@ -0,0 +1,168 @@
+#include "product.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+
+namespace {
+// Ranges with fewer factors than this are never split across threads, since
+// the cost of spawning a thread dominates.
+const size_t kMinParallelFactors = 64;
+
+Int make_int(uint64_t a) {
+  return Int(std::vector<uint32_t>{static_cast<uint32_t>(a & 0xFFFFFFFFULL),
+                                   static_cast<uint32_t>(a >> 32)});
+}
+
+// Multiplies factors[lo, hi) together by splitting the range in half and
+// recursing. The top log2(num_threads) levels run on separate threads.
+Int product_tree(std::vector<Int>& factors, size_t lo, size_t hi,
+                 unsigned num_threads) {
+  assert(lo < hi);
+  if (hi - lo == 1) {
+    return std::move(factors[lo]);
+  }
+  if (hi - lo == 2) {
+    return std::move(factors[lo] *= factors[lo + 1]);
+  }
+  const size_t mid = lo + (hi - lo) / 2;
+  if (num_threads > 1 && hi - lo >= kMinParallelFactors) {
+    const unsigned half_threads = num_threads / 2;
+    auto right = std::async(std::launch::async, product_tree,
+                            std::ref(factors), mid, hi, half_threads);
+    Int left = product_tree(factors, lo, mid, num_threads - half_threads);
+    return left *= right.get();
+  }
+  Int left = product_tree(factors, lo, mid, 1);
+  return left *= product_tree(factors, mid, hi, 1);
+}
+
+// Packs runs of consecutive words into single digit leaves while their
+// product fits in 32 bits, so that the product tree has fewer leaves.
+std::vector<Int> pack_words(const std::vector<uint32_t>& words) {
+  std::vector<Int> leaves;
+  uint64_t acc = 1;
+  for (const uint32_t w : words) {
+    if (w == 1) {
+      continue;
+    }
+    if (acc * w > 0xFFFFFFFFULL) {
+      leaves.push_back(make_int(acc));
+      acc = w;
+    } else {
+      acc *= w;
+    }
+  }
+  if (acc != 1 || leaves.empty()) {
+    leaves.push_back(make_int(acc));
+  }
+  return leaves;
+}
+
+Int product_of_words(const std::vector<uint32_t>& words,
+                     unsigned num_threads) {
+  return product(pack_words(words), num_threads);
+}
+
+// The swing of n is n! / (floor(n/2)!)^2. Its prime factorisation is cheap to
+// compute directly, and every prime power dividing it is at most n.
+Int swing(uint32_t n, const std::vector<uint32_t>& primes,
+          unsigned num_threads) {
+  std::vector<uint32_t> factors;
+  for (const uint32_t p : primes) {
+    if (p > n) {
+      break;
+    }
+    // The exponent of p is the number of odd quotients floor(n / p^i).
+    uint32_t p_power = 1;
+    uint32_t q = n;
+    while (q >= p) {
+      q /= p;
+      if (q & 1U) {
+        p_power *= p;
+      }
+    }
+    factors.push_back(p_power);
+  }
+  return product_of_words(factors, num_threads);
+}
+
+Int factorial_from_swings(uint32_t n, const std::vector<uint32_t>& primes,
+                          unsigned num_threads) {
+  if (n < 2) {
+    return 1;
+  }
+  Int half = factorial_from_swings(n / 2, primes, num_threads);
+  half *= half;
+  return half *= swing(n, primes, num_threads);
+}
+}  // namespace
+
+Int product(std::vector<Int> factors, unsigned num_threads) {
+  if (factors.empty()) {
+    return 1;
+  }
+  return product_tree(factors, 0, factors.size(), num_threads);
+}
+
+Int factorial(uint32_t n, unsigned num_threads) {
+  return factorial_from_swings(n, primes_up_to(n), num_threads);
+}
+
+Int binomial(uint32_t n, uint32_t k, unsigned num_threads) {
+  if (k > n) {
+    return 0;
+  }
+  const uint32_t n_minus_k = n - k;
+  std::vector<uint32_t> factors;
+  for (const uint32_t p : primes_up_to(n)) {
+    // By Legendre's formula the exponent of p is the sum over i of
+    // floor(n/p^i) - floor(k/p^i) - floor((n-k)/p^i), each term being 0 or 1.
+    uint32_t p_power = 1;
+    uint32_t a = n;
+    uint32_t b = k;
+    uint32_t c = n_minus_k;
+    while (a >= p) {
+      a /= p;
+      b /= p;
+      c /= p;
+      if (a - b - c == 1) {
+        p_power *= p;
+      }
+    }
+    factors.push_back(p_power);
+  }
+  return product_of_words(factors, num_threads);
+}
+
+Int primorial(uint32_t n, unsigned num_threads) {
+  return product_of_words(primes_up_to(n), num_threads);
+}
+
+std::vector<uint32_t> primes_up_to(uint32_t n) {
+  std::vector<uint32_t> primes;
+  if (n < 2) {
+    return primes;
+  }
+  // Sieve of Eratosthenes over the odd numbers; index i represents 2i + 1.
+  const uint32_t size = n / 2 + 1;
+  std::vector<bool> composite(size, false);
+  primes.push_back(2);
+  for (uint32_t i = 1; i < size; ++i) {
+    if (composite[i]) {
+      continue;
+    }
+    const uint64_t p = 2 * static_cast<uint64_t>(i) + 1;
+    if (p > n) {
+      break;
+    }
+    primes.push_back(static_cast<uint32_t>(p));
+    for (uint64_t j = p * p / 2; j < size; j += p) {
+      composite[j] = true;
+    }
+  }
+  return primes;
+}
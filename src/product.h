@@ -0,0 +1,60 @@
+#ifndef NUMBER_SRC_PRODUCT_H
+#define NUMBER_SRC_PRODUCT_H
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "integer.h"
+
+// Multiplies the factors together using a balanced product tree, so that each
+// multiplication is between operands of roughly the same size. If num_threads
+// is greater than 1 the top levels of the tree are computed concurrently.
+// The product of no factors is 1.
+Int product(std::vector<Int> factors, unsigned num_threads = 1);
+
+namespace product_internal {
+inline const Int& to_factor(const Int& a) { return a; }
+
+// Converts an integer of up to 64 bits exactly, where Int(int32_t) would
+// truncate wider or unsigned values.
+template <typename T, typename = typename std::enable_if<
+                          std::is_integral<T>::value>::type>
+Int to_factor(T a) {
+  static_assert(sizeof(T) <= sizeof(uint64_t), "factors are at most 64 bits");
+  const bool negative = std::is_signed<T>::value && a < T{0};
+  // Negating in uint64_t is exact even for the most negative value.
+  const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(a)
+                                      : static_cast<uint64_t>(a);
+  return Int(std::vector<uint32_t>{static_cast<uint32_t>(magnitude),
+                                   static_cast<uint32_t>(magnitude >> 32)},
+             negative);
+}
+}  // namespace product_internal
+
+// As above, for any range whose elements are Ints or integers of up to 64
+// bits.
+template <typename Range>
+Int product(const Range& factors, unsigned num_threads = 1) {
+  std::vector<Int> ints;
+  for (const auto& factor : factors) {
+    ints.push_back(product_internal::to_factor(factor));
+  }
+  return product(std::move(ints), num_threads);
+}
+
+// Returns n! computed with the prime swing algorithm.
+Int factorial(uint32_t n, unsigned num_threads = 1);
+
+// Returns n choose k, computed from its prime factorisation. Returns 0 if k is
+// greater than n.
+Int binomial(uint32_t n, uint32_t k, unsigned num_threads = 1);
+
+// Returns the product of all primes less than or equal to n.
+Int primorial(uint32_t n, unsigned num_threads = 1);
+
+// Returns the primes less than or equal to n in increasing order.
+std::vector<uint32_t> primes_up_to(uint32_t n);
+
+#endif  // NUMBER_SRC_PRODUCT_H
@@ -0,0 +1,99 @@
+#include "product.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "integer.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "gtest/gtest.h"
+#pragma clang diagnostic pop
+
+namespace {
+Int naive_factorial(uint32_t n) {
+  Int result{1};
+  for (uint32_t i = 2; i <= n; ++i) {
+    result *= Int(static_cast<int32_t>(i));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(ProductTest, Product) {
+  EXPECT_EQ(product(std::vector<Int>{}), 1);
+  EXPECT_EQ(product(std::vector<Int>{-7}), -7);
+  EXPECT_EQ(product(std::vector<Int>{2, 3, 5, 7}), 210);
+  EXPECT_EQ(product(std::vector<Int>{2, -3, 5, -7, 0}), 0);
+  EXPECT_EQ(product(std::vector<Int>{2, -3, 5, 7}), -210);
+
+  const Int a{"4294967295"};
+  const Int b{"4294967296"};
+  const Int c{"18446744069414584320"};
+  const int32_t small_factors[] = {3, 5};
+  EXPECT_EQ(product(std::vector<Int>{a, b}), c);
+  EXPECT_EQ(product(small_factors), 15);
+
+  // Elements wider than Int(int32_t) are converted exactly.
+  const std::vector<uint32_t> words{4294967295U, 2147483648U};
+  EXPECT_EQ(product(words), Int{"9223372034707292160"});
+  const std::vector<uint64_t> wide{18446744073709551615ULL, 3};
+  EXPECT_EQ(product(wide), Int{"55340232221128654845"});
+  const std::vector<int64_t> negative{-9223372036854775807LL - 1, -2, -1};
+  EXPECT_EQ(product(negative), Int{"-18446744073709551616"});
+  EXPECT_EQ(product(primes_up_to(30)), primorial(30));
+
+  std::vector<Int> many;
+  for (int32_t i = 1; i <= 300; ++i) {
+    many.push_back(i);
+  }
+  EXPECT_EQ(product(many), naive_factorial(300));
+  EXPECT_EQ(product(many, 4), naive_factorial(300));
+}
+
+TEST(ProductTest, Factorial) {
+  EXPECT_EQ(factorial(0), 1);
+  EXPECT_EQ(factorial(1), 1);
+  EXPECT_EQ(factorial(2), 2);
+  EXPECT_EQ(factorial(10), 3628800);
+  EXPECT_EQ(factorial(20), Int{"2432902008176640000"});
+  EXPECT_EQ(factorial(30), Int{"265252859812191058636308480000000"});
+  for (uint32_t n = 0; n < 70; ++n) {
+    EXPECT_EQ(factorial(n), naive_factorial(n));
+  }
+  EXPECT_EQ(factorial(500, 4), naive_factorial(500));
+}
+
+TEST(ProductTest, Binomial) {
+  EXPECT_EQ(binomial(0, 0), 1);
+  EXPECT_EQ(binomial(5, 0), 1);
+  EXPECT_EQ(binomial(5, 5), 1);
+  EXPECT_EQ(binomial(5, 6), 0);
+  EXPECT_EQ(binomial(5, 2), 10);
+  EXPECT_EQ(binomial(52, 5), 2598960);
+  EXPECT_EQ(binomial(100, 50), Int{"100891344545564193334812497256"});
+  for (uint32_t n = 0; n < 40; ++n) {
+    for (uint32_t k = 0; k <= n; ++k) {
+      EXPECT_EQ(binomial(n, k) * naive_factorial(k) * naive_factorial(n - k),
+                naive_factorial(n));
+    }
+  }
+}
+
+TEST(ProductTest, Primorial) {
+  EXPECT_EQ(primorial(0), 1);
+  EXPECT_EQ(primorial(1), 1);
+  EXPECT_EQ(primorial(2), 2);
+  EXPECT_EQ(primorial(10), 210);
+  EXPECT_EQ(primorial(30), Int{"6469693230"});
+}
+
+TEST(ProductTest, PrimesUpTo) {
+  const std::vector<uint32_t> empty;
+  EXPECT_EQ(primes_up_to(0), empty);
+  EXPECT_EQ(primes_up_to(1), empty);
+  const std::vector<uint32_t> small{2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+  EXPECT_EQ(primes_up_to(30), small);
+  EXPECT_EQ(primes_up_to(29), small);
+  EXPECT_EQ(primes_up_to(100000).size(), 9592U);
+}
@@ -0,0 +1,54 @@
+#include "shared_digits.h"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+SharedDigits::Buffer SharedDigits::zero_buffer{{2}, {0}};
+
+SharedDigits::SharedDigits(std::vector<uint32_t> digits)
+    : buffer(new Buffer{{1}, std::move(digits)}) {}
+
+SharedDigits::SharedDigits(const SharedDigits& other) noexcept
+    : buffer(other.buffer) {
+  // A new reference can only be made from an existing one, so no ordering
+  // with other threads is needed here.
+  if (buffer != &zero_buffer) {
+    buffer->references.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+SharedDigits::SharedDigits(SharedDigits&& other) noexcept
+    : buffer(other.buffer) {
+  other.buffer = &zero_buffer;
+}
+
+SharedDigits& SharedDigits::operator=(SharedDigits other) noexcept {
+  std::swap(buffer, other.buffer);
+  return *this;
+}
+
+SharedDigits::~SharedDigits() { release(); }
+
+std::vector<uint32_t>& SharedDigits::mutate() {
+  // The acquire load pairs with the release in release(), so that reads of
+  // the buffer through other copies have finished before it is written.
+  if (buffer->references.load(std::memory_order_acquire) != 1) {
+    Buffer* copy = new Buffer{{1}, buffer->digits};
+    release();
+    buffer = copy;
+  }
+  return buffer->digits;
+}
+
+void SharedDigits::release() {
+  if (buffer != &zero_buffer &&
+      buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete buffer;
+  }
+}
+
+bool operator==(const SharedDigits& lhs, const SharedDigits& rhs) {
+  return lhs.buffer == rhs.buffer || lhs.buffer->digits == rhs.buffer->digits;
+}
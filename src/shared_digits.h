@@ -0,0 +1,55 @@
+#ifndef NUMBER_SRC_SHARED_DIGITS_H
+#define NUMBER_SRC_SHARED_DIGITS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A vector of base 2^32 digits that is shared between copies until one of
+// them is modified (copy on write). Copying is O(1). Const access never
+// copies; every non-const member first gives this object its own buffer if
+// the current one is shared. The reference count is atomic, so copies of the
+// same value can be read and modified from different threads. Moving is O(1)
+// and takes the buffer without touching its reference count; the moved-from
+// object is left holding a shared, immortal zero, so it stays valid.
+class SharedDigits {
+ public:
+  explicit SharedDigits(std::vector<uint32_t> digits = {});
+  SharedDigits(const SharedDigits& other) noexcept;
+  SharedDigits(SharedDigits&& other) noexcept;
+  SharedDigits& operator=(SharedDigits other) noexcept;
+  ~SharedDigits();
+
+  const std::vector<uint32_t>& get() const { return buffer->digits; }
+  size_t size() const { return buffer->digits.size(); }
+  bool empty() const { return buffer->digits.empty(); }
+  const uint32_t& operator[](size_t i) const { return buffer->digits[i]; }
+  const uint32_t& back() const { return buffer->digits.back(); }
+
+  // Returns the digits for modification, copying them first if shared. Each
+  // call checks the reference count, so loops should call it once and work on
+  // the returned vector.
+  std::vector<uint32_t>& mutate();
+
+  friend bool operator==(const SharedDigits& lhs, const SharedDigits& rhs);
+
+ private:
+  struct Buffer {
+    std::atomic<size_t> references;
+    std::vector<uint32_t> digits;
+  };
+  // Never null.
+  Buffer* buffer;
+
+  // The single digit 0, held by moved-from objects. Its reference count is
+  // never updated and stays above 1, so mutate() always copies it and
+  // release() never deletes it.
+  static Buffer zero_buffer;
+
+  // Drops this object's reference, deleting the buffer if it was the last
+  // one. The caller must then point buffer elsewhere or be the destructor.
+  void release();
+};
+
+#endif  // NUMBER_SRC_SHARED_DIGITS_H
@@ -0,0 +1,217 @@
+// Measures the crossover points between the algorithm tiers of the integer
+// library on this machine and writes them out as integer_tuning.h.
+//
+// Usage: tune [output_path]
+// With no output path the header is written to standard output.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "integer.h"
+#include "mpn.h"
+
+namespace {
+// A crossover is accepted once the faster tier has won at this many
+// consecutive sizes, which filters out timing noise.
+const int kConsecutiveWins = 3;
+
+// Each measurement repeats the operation for at least this long and keeps
+// the best of several such runs.
+const std::chrono::microseconds kMinRunTime(2000);
+const int kRuns = 5;
+
+std::mt19937 gen(12345);
+
+std::vector<uint32_t> random_digits(size_t n) {
+  std::vector<uint32_t> digits(n);
+  for (uint32_t& digit : digits) {
+    digit = gen();
+  }
+  digits.back() |= 1;
+  return digits;
+}
+
+std::string random_decimal(size_t n) {
+  std::string decimal(n, '0');
+  for (char& c : decimal) {
+    c = static_cast<char>('0' + gen() % 10);
+  }
+  decimal[0] = '9';
+  return decimal;
+}
+
+// Returns the best time in seconds of one call to f.
+double time_per_call(const std::function<void()>& f) {
+  using Clock = std::chrono::steady_clock;
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < kRuns; ++run) {
+    int calls = 0;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point now = start;
+    while (now - start < kMinRunTime) {
+      f();
+      ++calls;
+      now = Clock::now();
+    }
+    best = std::min(best, std::chrono::duration<double>(now - start).count() /
+                              calls);
+  }
+  return best;
+}
+
+// Walks the sizes in increasing order and returns the first size from which
+// the faster tier wins kConsecutiveWins times in a row. faster_tier_wins
+// times both tiers at a size. Returns fallback if the faster tier never wins.
+size_t find_crossover(const std::vector<size_t>& sizes,
+                      const std::function<bool(size_t)>& faster_tier_wins,
+                      size_t fallback, const std::string& name) {
+  int wins = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (faster_tier_wins(sizes[i])) {
+      ++wins;
+      if (wins == kConsecutiveWins) {
+        const size_t crossover = sizes[i + 1 - kConsecutiveWins];
+        std::cerr << name << ": " << crossover << std::endl;
+        return crossover;
+      }
+    } else {
+      wins = 0;
+    }
+  }
+  std::cerr << name << ": no crossover found, using " << fallback
+            << std::endl;
+  return fallback;
+}
+
+std::vector<size_t> linear_sizes(size_t first, size_t last, size_t step) {
+  std::vector<size_t> sizes;
+  for (size_t n = first; n <= last; n += step) {
+    sizes.push_back(n);
+  }
+  return sizes;
+}
+
+std::vector<size_t> geometric_sizes(size_t first, size_t last) {
+  std::vector<size_t> sizes;
+  for (size_t n = first; n <= last; n += n / 8 + 1) {
+    sizes.push_back(n);
+  }
+  return sizes;
+}
+
+// Karatsuba with threshold n applies exactly one level of recursion to n
+// digit operands, which is what has to beat the schoolbook method at the
+// crossover.
+size_t tune_multiply() {
+  return find_crossover(
+      linear_sizes(4, 256, 2),
+      [](size_t n) {
+        const std::vector<uint32_t> a = random_digits(n);
+        const std::vector<uint32_t> b = random_digits(n);
+        std::vector<uint32_t> product(2 * n);
+        std::vector<uint32_t> scratch(mpn::mul_scratch_size(n, n));
+        return time_per_call([&] {
+                 mpn::mul_karatsuba(product.data(), a.data(), n, b.data(), n,
+                                    n, scratch.data());
+               }) < time_per_call([&] {
+                 mpn::mul_basecase(product.data(), a.data(), n, b.data(), n);
+               });
+      },
+      256, "kMultiplyKaratsubaThreshold");
+}
+
+size_t tune_square() {
+  return find_crossover(
+      linear_sizes(4, 256, 2),
+      [](size_t n) {
+        const std::vector<uint32_t> a = random_digits(n);
+        std::vector<uint32_t> square(2 * n);
+        std::vector<uint32_t> scratch(mpn::sqr_scratch_size(n));
+        return time_per_call([&] {
+                 mpn::sqr_karatsuba(square.data(), a.data(), n, n,
+                                    scratch.data());
+               }) < time_per_call([&] {
+                 mpn::sqr_basecase(square.data(), a.data(), n);
+               });
+      },
+      256, "kSquareKaratsubaThreshold");
+}
+
+size_t tune_from_decimal() {
+  return find_crossover(
+      geometric_sizes(64, 100000),
+      [](size_t n) {
+        const std::string decimal = random_decimal(n);
+        return time_per_call([&] { decimal_to_digits(decimal, n - 1); }) <
+               time_per_call([&] {
+                 decimal_to_digits(decimal, std::numeric_limits<size_t>::max());
+               });
+      },
+      100000, "kFromDecimalDivideAndConquerThreshold");
+}
+
+std::string tuning_header(size_t multiply, size_t square,
+                          size_t from_decimal) {
+  std::ostringstream out;
+  out << "// Algorithm crossover points used by the integer library.\n"
+         "//\n"
+         "// Generated by //src:tune on the machine that built this file. To "
+         "restore\n"
+         "// the defaults, check out this file again from version control.\n"
+         "\n"
+         "#ifndef NUMBER_SRC_INTEGER_TUNING_H\n"
+         "#define NUMBER_SRC_INTEGER_TUNING_H\n"
+         "\n"
+         "#include <cstddef>\n"
+         "\n"
+         "// Operands with at least this many digits are multiplied with "
+         "Karatsuba.\n"
+         "constexpr size_t kMultiplyKaratsubaThreshold = "
+      << multiply
+      << ";\n"
+         "\n"
+         "// Operands with at least this many digits are squared with "
+         "Karatsuba.\n"
+         "constexpr size_t kSquareKaratsubaThreshold = "
+      << square
+      << ";\n"
+         "\n"
+         "// Decimal strings longer than this many characters are converted "
+         "by splitting\n"
+         "// them in half recursively.\n"
+         "constexpr size_t kFromDecimalDivideAndConquerThreshold = "
+      << from_decimal
+      << ";\n"
+         "\n"
+         "#endif  // NUMBER_SRC_INTEGER_TUNING_H\n";
+  return out.str();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t multiply = tune_multiply();
+  const size_t square = tune_square();
+  const size_t from_decimal = tune_from_decimal();
+  const std::string header = tuning_header(multiply, square, from_decimal);
+  if (argc < 2) {
+    std::cout << header;
+    return 0;
+  }
+  std::ofstream file(argv[1]);
+  if (!file) {
+    std::cerr << "cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+  file << header;
+  return 0;
+}